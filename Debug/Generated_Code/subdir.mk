@@ -20,7 +20,7 @@ C_DEPS += \
 Generated_Code/%.o: ../Generated_Code/%.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cross ARM C Compiler'
-	arm-none-eabi-gcc -mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16 -O0 -fmessage-length=0 -fsigned-char -ffunction-sections -fdata-sections  -g3 -I"D:\Autumn 2019\Embedded Software\autumn-embedded-project\Library" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Static_Code/IO_Map" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Sources" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Generated_Code" -std=c99 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	arm-none-eabi-gcc -mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16 -O0 -fmessage-length=0 -fsigned-char -ffunction-sections -fdata-sections -Werror=return-type  -g3 -I"D:\Autumn 2019\Embedded Software\autumn-embedded-project\Library" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Static_Code/IO_Map" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Sources" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Generated_Code" -std=c99 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
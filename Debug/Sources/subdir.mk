@@ -11,9 +11,18 @@ C_SRCS += \
 ../Sources/PIT.c \
 ../Sources/RTC.c \
 ../Sources/UART.c \
+../Sources/acquisition.c \
 ../Sources/calculation.c \
+../Sources/dor.c \
 ../Sources/main.c \
-../Sources/packet.c 
+../Sources/metering.c \
+../Sources/overrun.c \
+../Sources/packet.c \
+../Sources/profile.c \
+../Sources/protection.c \
+../Sources/telemetry.c \
+../Sources/trip.c \
+../Sources/tripreport.c 
 
 OBJS += \
 ./Sources/FIFO.o \
@@ -23,9 +32,18 @@ OBJS += \
 ./Sources/PIT.o \
 ./Sources/RTC.o \
 ./Sources/UART.o \
+./Sources/acquisition.o \
 ./Sources/calculation.o \
+./Sources/dor.o \
 ./Sources/main.o \
-./Sources/packet.o 
+./Sources/metering.o \
+./Sources/overrun.o \
+./Sources/packet.o \
+./Sources/profile.o \
+./Sources/protection.o \
+./Sources/telemetry.o \
+./Sources/trip.o \
+./Sources/tripreport.o 
 
 C_DEPS += \
 ./Sources/FIFO.d \
@@ -35,16 +53,25 @@ C_DEPS += \
 ./Sources/PIT.d \
 ./Sources/RTC.d \
 ./Sources/UART.d \
+./Sources/acquisition.d \
 ./Sources/calculation.d \
+./Sources/dor.d \
 ./Sources/main.d \
-./Sources/packet.d 
+./Sources/metering.d \
+./Sources/overrun.d \
+./Sources/packet.d \
+./Sources/profile.d \
+./Sources/protection.d \
+./Sources/telemetry.d \
+./Sources/trip.d \
+./Sources/tripreport.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 Sources/%.o: ../Sources/%.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cross ARM C Compiler'
-	arm-none-eabi-gcc -mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16 -O0 -fmessage-length=0 -fsigned-char -ffunction-sections -fdata-sections  -g3 -I"D:\Autumn 2019\Embedded Software\autumn-embedded-project\Library" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Static_Code/IO_Map" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Sources" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Generated_Code" -std=c99 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	arm-none-eabi-gcc -mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16 -O0 -fmessage-length=0 -fsigned-char -ffunction-sections -fdata-sections -Werror=return-type  -g3 -I"D:\Autumn 2019\Embedded Software\autumn-embedded-project\Library" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Static_Code/IO_Map" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Sources" -I"D:/Autumn 2019/Embedded Software/autumn-embedded-project/Generated_Code" -std=c99 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -15,6 +15,7 @@
 #include "FIFO.h"
 #include "Cpu.h"
 #include "OS.h"
+#include "profile.h"
 
 
 #define FIFO_SIZE 256 /*!<  Number of bytes in a FIFO */
@@ -25,6 +26,7 @@ bool FIFO_Init(TFIFO * const fifo) /*!<  Initiate the FIFO */
   OS_DisableInterrupts();
   fifo->Start = fifo->End = 0; /*!<  Make both head and tails of the FIFO = 0, therefore empty */
   fifo->NbBytes = 0; /*!< Number of the bytes taken by the Buffer is equal to 0 when it is empty */
+  fifo->Wanted = 0; /*!< Nobody is waiting yet */
   fifo->EmptyFIFOSemaphore = OS_SemaphoreCreate(0);
   fifo->FullFIFOSemaphore = OS_SemaphoreCreate(0);
   OS_EnableInterrupts();
@@ -33,47 +35,96 @@ bool FIFO_Init(TFIFO * const fifo) /*!<  Initiate the FIFO */
 
 bool FIFO_Put(TFIFO * const fifo, const uint8_t data)
 {
-  OS_DisableInterrupts();
-  if (fifo->NbBytes == FIFO_SIZE) /*!<  If FIFO is full */
+  return FIFO_PutBlock(fifo, &data, 1);
+}
+
+
+bool FIFO_PutBlock(TFIFO * const fifo, const uint8_t data[], const uint16_t nbBytes)
+{
+  TCritical critical = CRITICAL_ENTER(CRITICAL_FIFO_PUT);
+  if (fifo->NbBytes + nbBytes > FIFO_SIZE) /*!<  If there is no room for all the bytes */
   {
-    OS_SemaphoreWait(fifo->FullFIFOSemaphore, 0);
-  } /*!<  FIFO was full, so deleting oldest data to replace with new one - will lose data every time FIFO-Put is called and it is full to avoid CPU interrupt error */
-  else
+    CRITICAL_EXIT(CRITICAL_FIFO_PUT, critical);
+    return false; /*!< None of the bytes are stored - waiting for room here would never end, the reader cannot run while the interrupts are masked, and the writer may be an ISR */
+  }
+  for (uint16_t byteNb = 0; byteNb < nbBytes; byteNb++)
   {
-    fifo->Buffer[fifo->End] = data; /*!<  Storing data in the new element of the array */
+    fifo->Buffer[fifo->End] = data[byteNb]; /*!<  Storing data in the new element of the array */
     fifo->End++; /*!< Create a potential new element in the Buffer Array to store the data */
     if (fifo->End == FIFO_SIZE)
     {
       fifo->End = 0; /*!<  Check for wrap around */
     }
-    fifo->NbBytes++; /*!< Increase the number of bytes = new data is written - to keep track of the number of bytes stored */
+  }
+  fifo->NbBytes += nbBytes; /*!< Increase the number of bytes = new data is written - to keep track of the number of bytes stored */
+  if ((fifo->Wanted != 0) && (fifo->NbBytes >= fifo->Wanted))
+  {
+    fifo->Wanted = 0; /*!< Waking the reader once, when everything it waits for is there */
     OS_SemaphoreSignal(fifo->EmptyFIFOSemaphore);
-    OS_EnableInterrupts();
-    return true; /*!< Successful */
   }
+  CRITICAL_EXIT(CRITICAL_FIFO_PUT, critical);
+  return true; /*!< Successful */
 }
 
 
-bool FIFO_Get(TFIFO * const fifo, uint8_t * const dataPtr)
+bool FIFO_Wait(TFIFO * const fifo, const uint16_t nbBytes, const uint32_t timeout)
 {
-  OS_DisableInterrupts();
-  if (fifo->NbBytes == 0) /*!< Empty if PutPt == GetPt */
-  {
-      OS_SemaphoreWait(fifo->EmptyFIFOSemaphore, 0);
-  }
-  else
+  for (;;)
   {
-    *dataPtr = fifo->Buffer[fifo->Start]; /*!< value at the address is equal to the character */
-    fifo->Start++;
-    if (fifo->Start == FIFO_SIZE)
+    TCritical critical = CRITICAL_ENTER(CRITICAL_FIFO_GET);
+    if (fifo->NbBytes >= nbBytes)
+    {
+      CRITICAL_EXIT(CRITICAL_FIFO_GET, critical);
+      return true; /*!< Already there, no need to sleep */
+    }
+    fifo->Wanted = nbBytes; /*!< FIFO_Put signals once that many bytes are stored */
+    CRITICAL_EXIT(CRITICAL_FIFO_GET, critical);
+    if (OS_SemaphoreWait(fifo->EmptyFIFOSemaphore, timeout) != OS_NO_ERROR) /*!< Sleeps with interrupts enabled, so the CPU goes to the idle thread */
     {
-      fifo->Start = 0; /*!<  Check for wrap around */
+      critical = CRITICAL_ENTER(CRITICAL_FIFO_GET);
+      fifo->Wanted = 0;
+      CRITICAL_EXIT(CRITICAL_FIFO_GET, critical);
+      return false; /*!< Not enough bytes before the timeout */
     }
-    fifo->NbBytes--; /*!< Getting the value is getting rid of the oldest value - Number of bytes decreases */
-    OS_SemaphoreSignal(fifo->FullFIFOSemaphore);
-    OS_EnableInterrupts();
-    return true; /*!<  Successful */
+    /*!< Checking again, the signal may be left over from a wait that timed out */
+  }
+}
+
+
+uint8_t FIFO_Peek(const TFIFO * const fifo, const uint16_t offset)
+{
+  uint16_t index = fifo->Start + offset;
+  if (index >= FIFO_SIZE)
+  {
+    index -= FIFO_SIZE; /*!<  Check for wrap around */
+  }
+  return fifo->Buffer[index];
+}
+
+
+void FIFO_Discard(TFIFO * const fifo, const uint16_t nbBytes)
+{
+  TCritical critical = CRITICAL_ENTER(CRITICAL_FIFO_GET);
+  fifo->Start += nbBytes;
+  if (fifo->Start >= FIFO_SIZE)
+  {
+    fifo->Start -= FIFO_SIZE; /*!<  Check for wrap around */
+  }
+  fifo->NbBytes -= nbBytes; /*!< Getting rid of the oldest values - Number of bytes decreases */
+  OS_SemaphoreSignal(fifo->FullFIFOSemaphore);
+  CRITICAL_EXIT(CRITICAL_FIFO_GET, critical);
+}
+
+
+bool FIFO_Get(TFIFO * const fifo, uint8_t * const dataPtr, const uint32_t timeout)
+{
+  if (!FIFO_Wait(fifo, 1, timeout))
+  {
+    return false; /*!< Still empty after the timeout */
   }
+  *dataPtr = FIFO_Peek(fifo, 0); /*!< value at the address is equal to the character */
+  FIFO_Discard(fifo, 1);
+  return true; /*!<  Successful */
 }
 
 /*!
@@ -26,8 +26,9 @@ typedef struct
   uint16_t Start;		/*!< The index of the position of the oldest data in the FIFO */
   uint16_t End; 		/*!< The index of the next available empty position in the FIFO */
   uint16_t volatile NbBytes;	/*!< The number of bytes currently stored in the FIFO */
+  uint16_t Wanted;		/*!< The number of bytes the reader is waiting for, 0 if it is not waiting */
   uint8_t Buffer[FIFO_SIZE];	/*!< The actual array of bytes to store the data */
-  OS_ECB* EmptyFIFOSemaphore;
+  OS_ECB* EmptyFIFOSemaphore;	/*!< Signaled when the number of bytes the reader is waiting for has been stored */
   OS_ECB* FullFIFOSemaphore;
 } TFIFO;
 
@@ -42,18 +43,59 @@ bool FIFO_Init(TFIFO * const fifo);
  *
  *  @param fifo A pointer to a FIFO struct where data is to be stored.
  *  @param data A byte of data to store in the FIFO buffer.
- *  @return bool - TRUE if data is successfully stored in the FIFO.
+ *  @return bool - TRUE if data is successfully stored in the FIFO, FALSE if it is full.
  *  @note Assumes that FIFO_Init has been called.
  */
 bool FIFO_Put(TFIFO * const fifo, const uint8_t data);
 
-/*! @brief Get one character from the FIFO.
+/*! @brief Put several bytes into the FIFO at once.
+ *
+ *  @param fifo A pointer to a FIFO struct where data is to be stored.
+ *  @param data The bytes of data to store in the FIFO buffer.
+ *  @param nbBytes The number of bytes to store.
+ *  @return bool - TRUE if all the bytes are stored, FALSE if there was no room for all of them and none are stored.
+ *  @note Assumes that FIFO_Init has been called. The bytes are stored in one critical section, so the bytes
+ *        of another writer never end up between them.
+ */
+bool FIFO_PutBlock(TFIFO * const fifo, const uint8_t data[], const uint16_t nbBytes);
+
+/*! @brief Wait for the FIFO to hold a number of bytes.
+ *
+ *  @param fifo A pointer to a FIFO struct with data to be retrieved.
+ *  @param nbBytes The number of bytes to wait for, at most FIFO_SIZE.
+ *  @param timeout The number of OS clock ticks to wait for, 0 to wait forever.
+ *  @return bool - TRUE if the FIFO holds at least nbBytes, FALSE if the timeout expired.
+ *  @note Assumes that FIFO_Init has been called. The calling thread sleeps while it waits, and is only woken
+ *        once all the bytes are there, not once per byte.
+ */
+bool FIFO_Wait(TFIFO * const fifo, const uint16_t nbBytes, const uint32_t timeout);
+
+/*! @brief Read a byte in place, without removing it from the FIFO.
+ *
+ *  @param fifo A pointer to a FIFO struct with data to be read.
+ *  @param offset The position of the byte from the oldest one.
+ *  @return uint8_t - the byte at the offset.
+ *  @note Only for the reader of the FIFO, after FIFO_Wait returned TRUE for more than offset bytes.
+ *        No lock is taken, the writer never changes the bytes already stored.
+ */
+uint8_t FIFO_Peek(const TFIFO * const fifo, const uint16_t offset);
+
+/*! @brief Remove the oldest bytes from the FIFO.
+ *
+ *  @param fifo A pointer to a FIFO struct with data to be removed.
+ *  @param nbBytes The number of bytes to remove, at most the number FIFO_Wait returned TRUE for.
+ *  @note Only for the reader of the FIFO. The bytes are removed in one critical section.
+ */
+void FIFO_Discard(TFIFO * const fifo, const uint16_t nbBytes);
+
+/*! @brief Get one character from the FIFO, waiting for one to be put if it is empty.
  *
  *  @param fifo A pointer to a FIFO struct with data to be retrieved.
  *  @param dataPtr A pointer to a memory location to place the retrieved byte.
- *  @return bool - TRUE if data is successfully retrieved from the FIFO.
- *  @note Assumes that FIFO_Init has been called.
+ *  @param timeout The number of OS clock ticks to wait for, 0 to wait forever.
+ *  @return bool - TRUE if data is successfully retrieved from the FIFO, FALSE if the timeout expired.
+ *  @note Assumes that FIFO_Init has been called. The calling thread sleeps while it waits, and a FIFO has only one reader.
  */
-bool FIFO_Get(TFIFO * const fifo, uint8_t * const dataPtr);
+bool FIFO_Get(TFIFO * const fifo, uint8_t * const dataPtr, const uint32_t timeout);
 
 #endif
@@ -22,7 +22,7 @@
 
 
 
-#define NUMBER_OF_CHANNELS 7 /*!< defining the number of channels available (0-7)*/
+#define NUMBER_OF_CHANNELS 8 /*!< defining the number of channels available (0-7)*/
 #define FIXED_FREQUENCY_CLOCK 2 /*!< assign the fixed frequency clock value to be set in FTMx_SC register (pg. 1210) */
 
 void* FTM0_Arguments[NUMBER_OF_CHANNELS]; /*!< creating a pointer of type void, to store an arguement, in an array the size of number of channels */
@@ -55,7 +55,7 @@ bool FTM_Init()
 bool FTM_Set(const TFTMChannel* const aFTMChannel)
 {
 
-  if ((aFTMChannel->timerFunction == TIMER_FUNCTION_INPUT_CAPTURE) && (aFTMChannel->channelNb <= NUMBER_OF_CHANNELS))
+  if ((aFTMChannel->timerFunction == TIMER_FUNCTION_INPUT_CAPTURE) && (aFTMChannel->channelNb < NUMBER_OF_CHANNELS))
   {
     FTM0_CnSC(aFTMChannel->channelNb) &= ~(FTM_CnSC_MSA_MASK | FTM_CnSC_MSB_MASK); /*!< Timer Function Output Compare sets MSA as 0 and MSB as 0 (pg. 1219)*/
     switch (aFTMChannel->ioType.inputDetection) /*!< Check value of inputDection for case statement */
@@ -82,7 +82,7 @@ bool FTM_Set(const TFTMChannel* const aFTMChannel)
     }
   }
 
-  else if ((aFTMChannel->timerFunction == TIMER_FUNCTION_OUTPUT_COMPARE) && (aFTMChannel->channelNb <= NUMBER_OF_CHANNELS))
+  else if ((aFTMChannel->timerFunction == TIMER_FUNCTION_OUTPUT_COMPARE) && (aFTMChannel->channelNb < NUMBER_OF_CHANNELS))
   {
     FTM0_CnSC(aFTMChannel->channelNb) |= (FTM_CnSC_MSA_MASK) & ~(FTM_CnSC_MSB_MASK); /*!<  Timer Function Output Compare sets MSA as 1 and MSB as 0 (pg. 1219)*/
     switch (aFTMChannel->ioType.outputAction) /*!< Check value of outputAction for case statement */
@@ -125,7 +125,7 @@ bool FTM_Set(const TFTMChannel* const aFTMChannel)
 bool FTM_StartTimer(const TFTMChannel* const aFTMChannel)
 {
 
-  if ((aFTMChannel->timerFunction == TIMER_FUNCTION_OUTPUT_COMPARE) && (aFTMChannel->channelNb <= NUMBER_OF_CHANNELS)) /*!< If Timer function set to output compare & set channel within range of channels (0-7)  */
+  if ((aFTMChannel->timerFunction == TIMER_FUNCTION_OUTPUT_COMPARE) && (aFTMChannel->channelNb < NUMBER_OF_CHANNELS)) /*!< If Timer function set to output compare & set channel within range of channels (0-7)  */
   {
     FTM0_CnV(aFTMChannel->channelNb) = (FTM0_CNT + (aFTMChannel->delayCount)); /*!< Set the 16-bit output compare register to CNT + Delay into current assigned channel, catering for overflow (ref. Timing and Generation 6.5) */
     FTM0_CnSC(aFTMChannel->channelNb) &= ~FTM_CnSC_CHF_MASK; /*!< Clear the output compare flag (ref. Timing and Generation 6.5) */
@@ -136,16 +136,31 @@ bool FTM_StartTimer(const TFTMChannel* const aFTMChannel)
 }
 
 
+bool FTM_StopTimer(const TFTMChannel* const aFTMChannel)
+{
+  if ((aFTMChannel->timerFunction == TIMER_FUNCTION_OUTPUT_COMPARE) && (aFTMChannel->channelNb < NUMBER_OF_CHANNELS))
+  {
+    FTM0_CnSC(aFTMChannel->channelNb) &= ~FTM_CnSC_CHIE_MASK; /*!< Disable channel interrupts, the pending compare is dropped */
+    FTM0_CnSC(aFTMChannel->channelNb) &= ~FTM_CnSC_CHF_MASK;
+    return true;
+  }
+  return false;
+}
+
+
 
 void __attribute__ ((interrupt)) FTM0_ISR(void)
 {
   OS_ISREnter();
   uint8_t channel; /*!< declare local variable channel, used in for loop */
-  for(channel=0;channel<=NUMBER_OF_CHANNELS; channel++) /*!< scroll through the channels to check if which interrupt flag enabled */
+  for(channel=0;channel<NUMBER_OF_CHANNELS; channel++) /*!< scroll through the channels to check if which interrupt flag enabled */
   {
-    if ((FTM0_CnSC(channel) & FTM_CnSC_CHF_MASK)) /*!< Check current channel status and control register to see if current channel flag raised */
+    if ((FTM0_CnSC(channel) & FTM_CnSC_CHF_MASK) && (FTM0_CnSC(channel) & FTM_CnSC_CHIE_MASK)) /*!< Check current channel status and control register to see if current channel flag raised */
     {
-      while (OS_SemaphoreSignal(FTMSemaphore) != OS_NO_ERROR);  //(*FTM0_Callback[channel])(FTM0_Arguments[channel]); /*!< Run the User Callback Function for channel with raised flag (in main, turning off Blue LED as requested in Lab 3 Hints) */
+      if (FTM0_CnSC(channel) & FTM_CnSC_MSA_MASK)
+        FTM0_CnSC(channel) &= ~FTM_CnSC_CHIE_MASK; /*!< An output compare is one shot, it would match again after the counter wraps */
+      if (FTM0_Callback[channel])
+        (*FTM0_Callback[channel])(FTM0_Arguments[channel]); /*!< Run the User Callback Function for channel with raised flag */
     }
     FTM0_CnSC(channel) &= ~FTM_CnSC_CHF_MASK; /*!< clear output flag */
   }
@@ -84,9 +84,18 @@ bool FTM_Set(const TFTMChannel* const aFTMChannel);
 bool FTM_StartTimer(const TFTMChannel* const aFTMChannel);
 
 
+/*! @brief Stops a timer if set up for output compare, before it has matched.
+ *
+ *  @param aFTMChannel is a structure containing the parameters to be used in setting up the timer channel.
+ *  @return bool - TRUE if the timer was stopped successfully.
+ *  @note Assumes the FTM has been initialized.
+ */
+bool FTM_StopTimer(const TFTMChannel* const aFTMChannel);
+
+
 /*! @brief Interrupt service routine for the FTM.
  *
- *  If a timer channel was set up as output compare, then the user callback function will be called.
+ *  If a timer channel was set up as output compare, then the user callback function will be called, once per FTM_StartTimer.
  *  @note Assumes the FTM has been initialized.
  */
 void __attribute__ ((interrupt)) FTM0_ISR(void);
@@ -43,6 +43,8 @@ static bool LaunchCommand(TFCCOB* commonCommandObject);
 static bool WritePhrase(const uint32_t address, const uint64union_t phrase);
 static bool EraseSector(const uint32_t address);
 static bool ModifyPhrase(const uint32_t address, const uint64union_t phrase);
+static bool ProgramBytePackets(const TPacket* const packet);
+static bool ReadBytePackets(const TPacket* const packet);
 
 /****************************************************************************************************************
  * Private Macro Definitions
@@ -55,6 +57,8 @@ bool Flash_Init(void)
 //  not needed
 //  SIM_SCGC3 |= SIM_SCGC3_NFC_MASK; /*!< enable NAND Flash Controller (bit 8) within system clock gate 3 register. (pg. 136, 343-344, 863) */
   while (!(FTFE_FSTAT & FTFE_FSTAT_CCIF_MASK)); /*!< Waiting for CCIF */
+  Packet_Register(FLASH_PROGRAM_COMMAND, ProgramBytePackets); /*!< The PC programs and reads the data sector through this module */
+  Packet_Register(FLASH_READ_COMMAND, ReadBytePackets);
   return true;
 }
 
@@ -290,6 +294,44 @@ static bool ModifyPhrase(const uint32_t address, const uint64union_t phrase)
 }
 
 
+/*! @brief Handles the packet to program bytes in FLASH
+ *
+ *  @param packet - packet taken off the packet queue
+ *  @return bool - TRUE if packet has been sent and handled successfully
+ *  @note Registered for FLASH_PROGRAM_COMMAND by Flash_Init
+ */
+static bool ProgramBytePackets(const TPacket* const packet)
+{
+  if (Packet_Parameter1(packet) == 8)
+  {
+    return Flash_Erase(); /*! < if Parameter1  = 8 - erase the whole sector */
+  }
+  else if (Packet_Parameter1(packet) > 8)
+  {
+    return false; //data sent is obsolete
+  }
+  else /*!< if offset (Parameter1) is between 0 and 7 inclusive, check the offset */
+  {
+    volatile uint8_t *address = (uint8_t *)(FLASH_DATA_START + Packet_Parameter1(packet));
+    return Flash_Write8(address, Packet_Parameter3(packet)); //Write in the Flash
+  }
+  return false;
+}
+
+
+/*! @brief Handles the packet to read bytes from FLASH
+ *
+ *  @param packet - packet taken off the packet queue
+ *  @return bool - TRUE if packet has been sent and handled successfully
+ *  @note Registered for FLASH_READ_COMMAND by Flash_Init
+ */
+static bool ReadBytePackets(const TPacket* const packet)
+{
+  uint8_t readByte = _FB(FLASH_DATA_START + Packet_Parameter1(packet)); /* !< fetching the Byte at offset Parameter1 and send it to PCc*/
+  return Packet_Put(FLASH_READ_COMMAND, Packet_Parameter1(packet), 0x0, readByte);
+}
+
+
 /*!
 * @}
 */
@@ -38,6 +38,7 @@ bool LEDs_Init(void)
 
   GPIOA_PDDR = GPIO_PDDR_PDD(LED_ORANGE) | GPIO_PDDR_PDD(LED_GREEN) | GPIO_PDDR_PDD(LED_BLUE) | GPIO_PDDR_PDD(LED_YELLOW); /*!< Port Data Direction Register, setting LEDs as outputs (pg. 2153) */
   GPIOA_PSOR |= GPIO_PSOR_PTSO(LED_GREEN) | GPIO_PSOR_PTSO(LED_YELLOW) | GPIO_PSOR_PTSO(LED_BLUE) | GPIO_PSOR_PTSO(LED_ORANGE); /*!< Turning off LEDs */
+  return true;
 }
 
 void LEDs_On(const TLED color)
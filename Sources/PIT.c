@@ -28,13 +28,9 @@ static void *PITArguments;
 static void (*PITCallback)(void* PITArguments);
 
 
-OS_ECB* PIT0Semaphore; //Declare Semaphore
-
-
 bool PIT_Init(const uint32_t moduleClk, void (*userFunction)(void*), void* userArguments)
 {
-  PITCallback = userFunction; /*!< Make the user function equal to PIT callback and accessible as global variable*/
-  PITArguments = userArguments; /*!< Make the user Argument a global variable*/
+  PIT_SetCallback(userFunction, userArguments);
   PIT_ModuleClk = moduleClk; /*!< Make the module clock a global variable to access in PIT_Set*/
 
   SIM_SCGC6 |= SIM_SCGC6_PIT_MASK; /*!< Enable PIT clock gate p356*/
@@ -56,12 +52,18 @@ bool PIT_Init(const uint32_t moduleClk, void (*userFunction)(void*), void* userA
   NVICICPR2 = (1 << 4);   /*!< Clear any pending interrupts with NVIC */
   NVICISER2 = (1 << 4);  /*!< Enable interrupts with NVIC */
 
-  PIT0Semaphore = OS_SemaphoreCreate(0); //Create a Semaphore
-
   return true;
 
 }
 
+void PIT_SetCallback(void (*userFunction)(void*), void* userArguments)
+{
+  NVICICER2 = (1 << 4); /*!< Only the PIT interrupt is held off while the function and its arguments change */
+  PITCallback = userFunction; /*!< Make the user function equal to PIT callback and accessible as global variable*/
+  PITArguments = userArguments; /*!< Make the user Argument a global variable*/
+  NVICISER2 = (1 << 4);
+}
+
 void PIT_Set(const uint32_t period, const bool restart, uint8_t channel) // Channel were used when using multiple PIT - but has been changed since then - kept it in case needed to use it again
 {
   if(restart) /*!< if restart == TRUE, restart the timer is disabled, then, new value, then enabled*/
@@ -133,23 +135,11 @@ void __attribute__ ((interrupt)) PIT0_ISR(void)
   /* Interrupt needs to be cleared at every ISR*/
   /*  !< Using Timer Flag Register 0 */
   PIT_TFLG0 |= PIT_TFLG_TIF_MASK; /*!< Clearing Timer Interrupt Flag after it is raised by writing 1 to it - p1344*/
-  PeriodComplete++; // Incrementing it to 16 to get the frequency
-  while (OS_SemaphoreSignal(PIT0Semaphore) != OS_NO_ERROR); //Signal I2C Semaphore (triggering I2C thread) and ensure it returns no error
-  OS_ISRExit(); //Exit Interrupt
-}
-
-
-
-void PIT0Thread(void* pData)
-{
-  for (;;)
+  if (PITCallback)
   {
-    OS_SemaphoreWait(PIT0Semaphore, 0);
-    if (PITCallback)
-    {
-      (*PITCallback)(PITArguments);
-    }
+    (*PITCallback)(PITArguments); // Runs in the ISR, no thread in between
   }
+  OS_ISRExit(); //Exit Interrupt
 }
 
 
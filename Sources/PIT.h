@@ -15,20 +15,25 @@
 #include "types.h"
 
 
-bool ResetMode;
-uint8_t PeriodComplete;
-
 /*! @brief Sets up the PIT before first use.
  *
  *  Enables the PIT and freezes the timer when debugging.
  *  @param moduleClk The module clock rate in Hz.
- *  @param userFunction is a pointer to a user callback function.
+ *  @param userFunction is a pointer to a user callback function, called from the ISR.
  *  @param userArguments is a pointer to the user arguments to use with the user callback function.
  *  @return bool - TRUE if the PIT was successfully initialized.
  *  @note Assumes that moduleClk has a period which can be expressed as an integral number of nanoseconds.
  */
 bool PIT_Init(const uint32_t moduleClk, void (*userFunction)(void*), void* userArguments);
 
+/*! @brief Registers the function called from the ISR on every timeout.
+ *
+ *  @param userFunction is a pointer to a user callback function, NULL for none.
+ *  @param userArguments is a pointer to the user arguments to use with the user callback function.
+ *  @note The callback runs in interrupt context, so it must be short and must not wait.
+ */
+void PIT_SetCallback(void (*userFunction)(void*), void* userArguments);
+
 /*! @brief Sets the value of the desired period of the PIT.
  *
  *  @param period The desired value of the timer period in nanoseconds.
@@ -49,18 +54,10 @@ void PIT_Enable(const bool enable, uint8_t channel);
 /*! @brief Interrupt service routine for the PIT.
  *
  *  The periodic interrupt timer has timed out.
- *  The user callback function will be called.
+ *  The user callback function will be called and the registered semaphore signaled.
  *  @note Assumes the PIT has been initialized.
  */
 void __attribute__ ((interrupt)) PIT0_ISR(void);
 //void __attribute__ ((interrupt)) PIT1_ISR(void);
 
-
-
-/*! @brief PIT Thread
- *
- *Every period, this function is triggered and the waveform is sampled.
- */
-void PIT0Thread(void* pData);
-
 #endif
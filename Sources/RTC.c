@@ -26,6 +26,8 @@ static void (*RTCCallback)(void* RTCArguments);
 
 OS_ECB* RTCSemaphore; //Declare Semaphore
 
+static bool TowerTimePackets(const TPacket* const packet);
+
 bool RTC_Init(void (*userFunction)(void*), void* userArguments)
 {
   RTCCallback = userFunction; /*!< Make the user function equal to RTC callback and accessible as global variable*/
@@ -33,33 +35,49 @@ bool RTC_Init(void (*userFunction)(void*), void* userArguments)
 
   SIM_SCGC6 |= SIM_SCGC6_RTC_MASK; /*!< Enable Clock Gate Control Register for RTC */
 
-  /*!< Need to configure the capacitors - from schematics: use 18pF ==> 16 +2 */
-  RTC_CR |= RTC_CR_SC16P_MASK;
-  RTC_CR |= RTC_CR_SC2P_MASK;
-
-  RTC_CR |= RTC_CR_OSCE_MASK; /*!<  oscillator is enabled. After setting this bit */
-   /*!<wait the oscillator startup time before enabling the time counter to allow the 32.768 kHz clock time to stabilize. */
-  for(int i= 0; i < 1000000; i++)
+  /*!< The RTC is battery backed, so the oscillator only has to be started after the battery was removed */
+  if (!(RTC_CR & RTC_CR_OSCE_MASK))
   {
+    /*!< Need to configure the capacitors - from schematics: use 18pF ==> 16 +2 */
+    RTC_CR |= RTC_CR_SC16P_MASK;
+    RTC_CR |= RTC_CR_SC2P_MASK;
+
+    RTC_CR |= RTC_CR_OSCE_MASK; /*!<  oscillator is enabled. After setting this bit */
+     /*!<wait the oscillator startup time before enabling the time counter to allow the 32.768 kHz clock time to stabilize. */
+    for(int i= 0; i < 1000000; i++)
+    {
+    }
   }
 
   RTC_LR &= ~RTC_LR_CRL_MASK; /*! <Lock the control register after setting it p1398 - needs to be cleared to lock the register*/
 
-  RTC_IER |= RTC_IER_TSIE_MASK; /*!<Enable every second interrupt*/
+  if (userFunction)
+  {
+    /*!< The every second interrupt only signals RTCThread, which has to be created along with it */
+    RTCSemaphore = OS_SemaphoreCreate(0); //Create a semaphore
+    RTC_IER |= RTC_IER_TSIE_MASK; /*!<Enable every second interrupt*/
+    /*!< IRQ RTC seconds = 67
+     * 67%32 = 3 */
+    NVICICPR2 = (1 << 3);  // Clear any pending interrupts with NVIC
+    NVICISER2 = (1 << 3); // Enable interrupts with NVIC
+  }
+  else
+    RTC_IER &= ~RTC_IER_TSIE_MASK; /*!< Nothing waits for the seconds, so do not interrupt every second */
+
   //RTC_TSR = 0; Need to be reset or not ???
   RTC_SR |= RTC_SR_TCE_MASK; /*!< Enable Time Counter from RTC status Register (p1395)*/
 
-  /*!< IRQ RTC seconds = 67
-   * 67%32 = 3 */
-  NVICICPR2 = (1 << 3);  // Clear any pending interrupts with NVIC
-  NVICISER2 = (1 << 3); // Enable interrupts with NVIC
-  RTCSemaphore = OS_SemaphoreCreate(0); //Create a semaphore
-
   return true;
 
 }
 
 
+void RTC_RegisterCommands(void)
+{
+  Packet_Register(SET_TIME_COMMAND, TowerTimePackets); //The PC can only set the time once the RTC is running
+}
+
+
 void RTC_Set(const uint8_t hours, const uint8_t minutes, const uint8_t seconds)
 {
   uint32_t timeSet = (hours*3600)+(minutes*60)+ seconds; /*hours minutes and seconds converted to seconds*/
@@ -69,7 +87,7 @@ void RTC_Set(const uint8_t hours, const uint8_t minutes, const uint8_t seconds)
 }
 
 
-void RTC_Get(uint8_t* const hours, uint8_t* const minutes, uint8_t* const seconds)
+uint32_t RTC_Seconds(void)
 {
   uint32_t currentTime = RTC_TSR; /*!< current time stored in RTC Time Seconds Register p1390 of reference manual*/
   uint32_t matchTime = RTC_TSR; /*!< Read it a second time to check if they are equal */
@@ -80,6 +98,13 @@ void RTC_Get(uint8_t* const hours, uint8_t* const minutes, uint8_t* const second
     currentTime = RTC_TSR;
     matchTime = RTC_TSR;
   }
+  return currentTime;
+}
+
+
+void RTC_Get(uint8_t* const hours, uint8_t* const minutes, uint8_t* const seconds)
+{
+  uint32_t currentTime = RTC_Seconds();
   *hours = ((currentTime/3600)%24); /*!< Convert seconds into hours  and found the modulus of 24 to not go over 24 hours*/
   *minutes = (currentTime%3600) /60; /*!< Convert seconds to minutes */
   *seconds = (currentTime%3600)%60; /*!< Convert seconds of the day to second of the minute */
@@ -108,6 +133,33 @@ void RTCThread(void* pData)
     Packet_Put(SET_TIME_COMMAND, hours, minutes, seconds);
   }
 }
+
+/*! @brief Handles the packet RTC time - sends back ther packet to PC if setting time is successful
+ *
+ *  @param packet - packet taken off the packet queue
+ *  @return bool - TRUE if packet has been sent and handled successfully
+ *  @note Registered for SET_TIME_COMMAND by RTC_RegisterCommands
+ */
+static bool TowerTimePackets(const TPacket* const packet)
+{
+  /*!< Checking if input is valid, if not, return false */
+  if (Packet_Parameter1(packet) <= 23)
+  {
+    if (Packet_Parameter2(packet) <= 59)
+    {
+      if (Packet_Parameter3(packet) <= 59)
+      {
+        /*!< sets the time with packet parameters given by PC */
+        RTC_Set(Packet_Parameter1(packet), Packet_Parameter2(packet), Packet_Parameter3(packet));
+        /*!< returns the original packet to the PC if successful */
+        return Packet_Put(SET_TIME_COMMAND, Packet_Parameter1(packet), Packet_Parameter2(packet), Packet_Parameter3(packet));
+      }
+    }
+  }
+  return false;
+}
+
+
 /*!
 * @}
 */
@@ -16,14 +16,20 @@
 
 /*! @brief Initializes the RTC before first use.
  *
- *  Sets up the control register for the RTC and locks it.
- *  Enables the RTC and sets an interrupt every second.
- *  @param userFunction is a pointer to a user callback function.
+ *  Sets up the control register for the RTC and locks it, waiting for the oscillator only if it was stopped.
+ *  Enables the RTC, and sets an interrupt every second when there is a user callback function.
+ *  @param userFunction is a pointer to a user callback function, NULL to leave the seconds interrupt off.
  *  @param userArguments is a pointer to the user arguments to use with the user callback function.
  *  @return bool - TRUE if the RTC was successfully initialized.
  */
 bool RTC_Init(void (*userFunction)(void*), void* userArguments);
 
+/*! @brief Registers the set time command with the packet dispatch.
+ *
+ *  @note Assumes that RTC_Init was called.
+ */
+void RTC_RegisterCommands(void);
+
 /*! @brief Sets the value of the real time clock.
  *
  *  @param hours The desired value of the real time clock hours (0-23).
@@ -33,6 +39,13 @@ bool RTC_Init(void (*userFunction)(void*), void* userArguments);
  */
 void RTC_Set(const uint8_t hours, const uint8_t minutes, const uint8_t seconds);
 
+/*! @brief Gets the seconds counted by the real time clock.
+ *
+ *  @return uint32_t - seconds since the clock was set to 00:00:00.
+ *  @note Assumes that the RTC module has been initialized.
+ */
+uint32_t RTC_Seconds(void);
+
 /*! @brief Gets the value of the real time clock.
  *
  *  @param hours The address of a variable to store the real time clock hours.
@@ -90,9 +90,24 @@ bool UART_Init(const uint32_t baudRate, const uint32_t moduleClk)
   return true; /*!< return true if it has a character otherwise false. */
 }
 
-bool UART_InChar(uint8_t* const dataPtr)
+bool UART_InChar(uint8_t* const dataPtr, const uint32_t timeout)
 {
-  return (FIFO_Get(&RxFIFO, dataPtr));  /*!< Attempt to GET data from RxFIFO if empty return false, if data return true */
+  return (FIFO_Get(&RxFIFO, dataPtr, timeout));  /*!< Sleeps until RxFIFO has data, return false if none came before the timeout */
+}
+
+bool UART_InWait(const uint16_t nbBytes, const uint32_t timeout)
+{
+  return FIFO_Wait(&RxFIFO, nbBytes, timeout);
+}
+
+uint8_t UART_InPeek(const uint16_t offset)
+{
+  return FIFO_Peek(&RxFIFO, offset);
+}
+
+void UART_InDiscard(const uint16_t nbBytes)
+{
+  FIFO_Discard(&RxFIFO, nbBytes);
 }
 
 bool UART_OutChar(const uint8_t data)
@@ -105,15 +120,22 @@ bool UART_OutChar(const uint8_t data)
   return success;
 }
 
+bool UART_Out(const uint8_t data[], const uint16_t nbBytes)
+{
+  bool success = FIFO_PutBlock(&TxFIFO, data, nbBytes);
+  UART2_C2 |= UART_C2_TIE_MASK; /*!< Enabling Transmitter Interrupt when data is ready to transmit */
+  return success;
+}
+
 void UART_Poll(void)
 {
   if (UART2_S1 & UART_S1_RDRF_MASK) /*!< Checking UART2 Status Register (pg. 1913) as well as the checking the 6th bit of the register (Receive Data Register Full Flag - Bit 5) to see if there are received packets */
   {
       FIFO_Put(&RxFIFO, UART2_D);  /*!< receiving data, FIFO puts value of UART2_D (pg. 1919). UART2_D Reads return the contents of the read-only receive data register and writes go to the write-only transmit data register. */
   }
-  if (UART2_S1 & UART_S1_TDRE_MASK) /*!< Checking UART2 Status Register (pg. 1913) as well as the checking the 8th bit of the register (Transmit Data Register Empty Flag - Bit 7) to see if the flag has been raised */
+  if ((UART2_S1 & UART_S1_TDRE_MASK) && (TxFIFO.NbBytes > 0)) /*!< Checking UART2 Status Register (pg. 1913) as well as the checking the 8th bit of the register (Transmit Data Register Empty Flag - Bit 7) to see if the flag has been raised, and only polling if there is data so FIFO_Get does not wait */
   {
-      FIFO_Get(&TxFIFO, (uint8_t *) &UART2_D); /*!< transmitting data, FIFO gets the value at the address of UART2_D (pg. 1919). UART2_D Reads return the contents of the read-only receive data register and writes go to the write-only transmit data register. */
+      FIFO_Get(&TxFIFO, (uint8_t *) &UART2_D, 0); /*!< transmitting data, FIFO gets the value at the address of UART2_D (pg. 1919). UART2_D Reads return the contents of the read-only receive data register and writes go to the write-only transmit data register. */
   }
 }
 
@@ -158,7 +180,7 @@ void UARTTXThread(void* pData)
     OS_SemaphoreWait(UARTTXSemaphore, 0); //Wait for semaphore to be signaled.
     if (UART2_S1 & UART_S1_TDRE_MASK) // Clear TDRE flag by reading it
     {
-      FIFO_Get(&TxFIFO,(uint8_t* )&UART2_D);
+      FIFO_Get(&TxFIFO,(uint8_t* )&UART2_D, 0); // Sleeps until there is something to transmit
     }
     UART2_C2 |= UART_C2_TIE_MASK; // Re-enable transmission interrupt
 
@@ -22,14 +22,39 @@
  */
 bool UART_Init(const uint32_t baudRate, const uint32_t moduleClk);
  
-/*! @brief Get a character from the receive FIFO if it is not empty.
+/*! @brief Get a character from the receive FIFO, waiting for one to be received if it is empty.
  *
  *  @param dataPtr A pointer to memory to store the retrieved byte.
- *  @return bool - TRUE if the receive FIFO returned a character.
+ *  @param timeout The number of OS clock ticks to wait for, 0 to wait forever.
+ *  @return bool - TRUE if the receive FIFO returned a character, FALSE if the timeout expired.
  *  @note Assumes that UART_Init has been called.
  */
-bool UART_InChar(uint8_t* const dataPtr);
+bool UART_InChar(uint8_t* const dataPtr, const uint32_t timeout);
  
+/*! @brief Wait for a number of bytes to be received.
+ *
+ *  @param nbBytes The number of bytes to wait for.
+ *  @param timeout The number of OS clock ticks to wait for, 0 to wait forever.
+ *  @return bool - TRUE if the receive FIFO holds at least nbBytes, FALSE if the timeout expired.
+ *  @note Assumes that UART_Init has been called.
+ */
+bool UART_InWait(const uint16_t nbBytes, const uint32_t timeout);
+
+/*! @brief Read a received byte in place, without removing it from the receive FIFO.
+ *
+ *  @param offset The position of the byte from the oldest one received.
+ *  @return uint8_t - the byte at the offset.
+ *  @note Assumes that UART_InWait returned TRUE for more than offset bytes.
+ */
+uint8_t UART_InPeek(const uint16_t offset);
+
+/*! @brief Remove the oldest received bytes from the receive FIFO.
+ *
+ *  @param nbBytes The number of bytes to remove.
+ *  @note Assumes that UART_InWait returned TRUE for at least nbBytes.
+ */
+void UART_InDiscard(const uint16_t nbBytes);
+
 /*! @brief Put a byte in the transmit FIFO if it is not full.
  *
  *  @param data The byte to be placed in the transmit FIFO.
@@ -38,6 +63,15 @@ bool UART_InChar(uint8_t* const dataPtr);
  */
 bool UART_OutChar(const uint8_t data);
 
+/*! @brief Put several bytes in the transmit FIFO at once, if there is room for all of them.
+ *
+ *  @param data The bytes to be placed in the transmit FIFO.
+ *  @param nbBytes The number of bytes.
+ *  @return bool - TRUE if all the bytes were placed in the transmit FIFO, FALSE if none were.
+ *  @note Assumes that UART_Init has been called. No other byte is sent between them.
+ */
+bool UART_Out(const uint8_t data[], const uint16_t nbBytes);
+
 /*! @brief Poll the UART status register to try and receive and/or transmit one character.
  *
  *  @return void
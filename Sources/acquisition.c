@@ -0,0 +1,107 @@
+/*! @file
+ *
+ *  @brief Routines to acquire the analog channels into a queue of timestamped frames.
+ *
+ *  This contains the functions for operating the acquisition queue.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup acquisition_module acquisition module documentation
+**  @{
+*/
+
+#include "acquisition.h"
+#include "analog.h"
+#include "OS.h"
+#include "profile.h"
+
+static TSampleFrame Frames[ACQUISITION_QUEUE_SIZE]; /*!< Ring of frames */
+static uint32_t Head;                 /*!< Number of frames written, only written by Acquisition_Sample */
+static uint32_t Tail;                 /*!< Number of frames read, only written by Acquisition_Get */
+static volatile uint32_t Ticks;       /*!< PIT ticks so far, only written by Acquisition_Sample */
+static uint32_t Dropped;              /*!< Frames lost because the queue was full */
+static OS_ECB* BlockReadySemaphore;   /*!< Signaled once per block of frames */
+
+
+bool Acquisition_Init(void)
+{
+  Head = 0;
+  Tail = 0;
+  Ticks = 0;
+  Dropped = 0;
+  BlockReadySemaphore = OS_SemaphoreCreate(0);
+  return true;
+}
+
+
+void Acquisition_Sample(void)
+{
+  uint32_t sequence = Ticks++; // Counted even if the frame is dropped, so the gap shows
+  // Blocks end on the sequence, which the overrun deadlines count in, not on the ring position, which stops on a drop
+  bool blockEnd = (((sequence + 1) % ACQUISITION_BLOCK_SIZE) == 0);
+  uint32_t head = Head;
+  if (head - LOAD_ACQUIRE(Tail) == ACQUISITION_QUEUE_SIZE)
+  {
+    Dropped++; // The oldest frame may be being read, so the newest one is lost
+    if (blockEnd)
+      (void) OS_SemaphoreSignal(BlockReadySemaphore); // The queue is full, there is still a block to drain
+    return;
+  }
+
+  TSampleFrame* const frame = &Frames[head & ACQUISITION_QUEUE_MASK];
+  // Only the analog hardware is shared with the processing thread, which writes the outputs
+  TCritical critical = CRITICAL_ENTER(CRITICAL_ANALOG_GET);
+  PROFILE_BEGIN(PROFILE_ANALOG_GET);
+  frame->sequence = sequence;
+  frame->timestamp = Profile_Now();
+  for (uint8_t analogNb = 0; analogNb < NB_ANALOG_CHANNELS; analogNb++)
+    Analog_Get(analogNb, &frame->samples[analogNb]);
+  PROFILE_END(PROFILE_ANALOG_GET);
+  CRITICAL_EXIT(CRITICAL_ANALOG_GET, critical);
+#ifdef PROFILE_ENABLED
+  static uint32_t lastTimestamp;
+  if (head)
+    Profile_Record(PROFILE_SAMPLE_INTERVAL, frame->timestamp - lastTimestamp);
+  lastTimestamp = frame->timestamp;
+#endif
+
+  STORE_RELEASE(Head, head + 1); // Publish the frame
+  if (blockEnd)
+    (void) OS_SemaphoreSignal(BlockReadySemaphore);
+}
+
+
+void Acquisition_Wait(void)
+{
+  (void) OS_SemaphoreWait(BlockReadySemaphore, 0);
+}
+
+
+bool Acquisition_Get(TSampleFrame* const frame)
+{
+  uint32_t tail = Tail;
+  if (tail == LOAD_ACQUIRE(Head))
+    return false;
+  *frame = Frames[tail & ACQUISITION_QUEUE_MASK];
+  STORE_RELEASE(Tail, tail + 1); // Give the slot back to Acquisition_Sample
+  return true;
+}
+
+
+uint32_t Acquisition_Ticks(void)
+{
+  return Ticks;
+}
+
+
+uint32_t Acquisition_Dropped(void)
+{
+  return Dropped;
+}
+
+/*!
+* @}
+*/
@@ -0,0 +1,81 @@
+/*! @file
+ *
+ *  @brief Routines to acquire the analog channels into a queue of timestamped frames.
+ *
+ *  Every PIT tick takes one sample of all the channels into a frame. The frames go through a
+ *  single-producer/single-consumer ring: the PIT side only writes the head and the processing
+ *  thread only writes the tail, so neither side has to mask interrupts to share it.
+ *  The processing thread is signaled once every ACQUISITION_BLOCK_SIZE frames and drains the queue.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+// new types
+#include "types.h"
+#include "calculation.h"
+
+#ifndef NB_ANALOG_CHANNELS
+#define NB_ANALOG_CHANNELS      3                          /*!< Channels sampled on every tick, up to ANALOG_NB_INPUTS */
+#endif
+#define ACQUISITION_BLOCK_SIZE  NB_SAMPLES                 /*!< Frames per signal, the processing thread wakes once per block */
+#define ACQUISITION_QUEUE_SIZE  (2*ACQUISITION_BLOCK_SIZE) /*!< Frames the queue can hold, must be a power of 2 */
+#define ACQUISITION_QUEUE_MASK  (ACQUISITION_QUEUE_SIZE - 1)
+
+// Ordering of the single-producer/single-consumer queues: the data must be written before the index that publishes it,
+// and read before the index that frees it
+#define LOAD_ACQUIRE(x)         __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(x, v)     __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+typedef struct
+{
+  uint32_t sequence;                    /*!< Number of the PIT tick the frame was sampled on, a gap means frames were dropped */
+  uint32_t timestamp;                   /*!< Time the frame was sampled, from Profile_Now */
+  int16_t samples[NB_ANALOG_CHANNELS];  /*!< Sample of each channel */
+} TSampleFrame;
+
+/*! @brief Sets up the acquisition before first use.
+ *
+ *  @return bool - TRUE if the acquisition was successfully initialized.
+ *  @note Assumes that Analog_Init and Profile_Init were called.
+ */
+bool Acquisition_Init(void);
+
+/*! @brief Samples all the channels into a new frame at the head of the queue.
+ *
+ *  The frame is dropped if the queue is full. The processing thread is signaled every ACQUISITION_BLOCK_SIZE ticks,
+ *  on the same sequence the overrun deadlines are counted in, whether the last frame of the block was dropped or not.
+ *  @note Called once per sample period, from the PIT ISR. It is the only writer of the queue.
+ */
+void Acquisition_Sample(void);
+
+/*! @brief Waits until the next block of frames has been queued.
+ *
+ *  @note Assumes that Acquisition_Init was called.
+ */
+void Acquisition_Wait(void);
+
+/*! @brief Takes the oldest frame out of the queue.
+ *
+ *  @param frame - copy of the oldest frame.
+ *  @return bool - TRUE if a frame was available.
+ *  @note Only one thread may read the queue.
+ */
+bool Acquisition_Get(TSampleFrame* const frame);
+
+/*! @brief Gets the number of PIT ticks since Acquisition_Init.
+ *
+ *  @return uint32_t - sequence number the next frame will have.
+ */
+uint32_t Acquisition_Ticks(void);
+
+/*! @brief Gets the number of frames dropped because the queue was full.
+ *
+ *  @return uint32_t - number of frames dropped since Acquisition_Init.
+ */
+uint32_t Acquisition_Dropped(void);
+
+#endif
@@ -7,23 +7,90 @@
  *  @date 2019-04-16
  */
 
+#ifndef CALCULATION_H
+#define CALCULATION_H
+
 #include <math.h> // Including math.h to do the square root of some values
 #include "types.h"
 
+#define NB_SAMPLES          16 /*!< Number of samples per cycle - must be a power of 2 (16, 32, 64) */
+#define SAMPLES_MASK        (NB_SAMPLES - 1) /*!< Used to wrap the head of the sliding window */
+#define SAMPLE_PERIOD       (20000000 / NB_SAMPLES) /*!< Sample period in ns for a 50Hz waveform */
+
+// Define CALCULATION_FLOAT to use the floating point measurement path instead of the fixed point one
+//#define CALCULATION_FLOAT
+
+#ifdef CALCULATION_FLOAT
+typedef float TSample;    /*!< Sample in V */
+typedef float TVoltage;   /*!< Voltage RMS in V */
+typedef float TCurrent;   /*!< Current RMS in A */
+#define CURRENT_FROM_AMPS(X)      ((float) (X))
+#define CURRENT_TO_CENTIAMPS(X)   ((uint32_t) ((X)*100))
+#define CURRENT_TO_MILLIAMPS(X)   ((uint32_t) ((X)*1000))
+#else
+typedef int16_t TSample;  /*!< Sample in ADC counts */
+typedef uint32_t TVoltage; /*!< Voltage RMS in ADC counts, with RMS_FRACTION_BITS fractional bits */
+typedef uint32_t TCurrent; /*!< Current RMS in mA */
+#define CURRENT_FROM_AMPS(X)      ((uint32_t) ((X)*1000))
+#define CURRENT_TO_CENTIAMPS(X)   ((X)/10)
+#define CURRENT_TO_MILLIAMPS(X)   (X)
+#define RMS_FRACTION_BITS   4 /*!< Fractional bits kept by the integer square root */
+#define CURRENT_SCALE       57145 /*!< 1000/(ADC_RATE*0.350) in Q16 - ADC counts RMS to mA RMS */
+#endif
+
+#define TWIDDLE_SIZE        64 /*!< Number of entries of the cosine table, NB_SAMPLES must divide it */
+
+typedef enum
+{
+  MEASUREMENT_RMS,        /*!< True RMS of the window, including harmonics and DC offset */
+  MEASUREMENT_FUNDAMENTAL /*!< RMS of the fundamental only, from the sliding DFT */
+}TMeasurement;
+
+extern TMeasurement Current_Measurement; // Keeping track of the quantity the protection acts on
+
+#define CURRENT_PICKUP      CURRENT_FROM_AMPS(1.03) /*!< Current RMS above which the IDMT timing starts */
+
 typedef struct
 {
-  float voltage[16];
-  float voltageSqr[16];
+  TSample voltage[NB_SAMPLES]; /*!< Circular window of the last NB_SAMPLES voltages */
+#ifdef CALCULATION_FLOAT
+  float voltageSqr[NB_SAMPLES]; /*!< Circular window of the last NB_SAMPLES voltages square */
   float totalVoltageSqr;
-  float voltageRMS;
-  float currentRMS;
+  float fundamentalRe; /*!< Real part of the fundamental DFT bin of the window */
+  float fundamentalIm; /*!< Imaginary part of the fundamental DFT bin of the window */
+#else
+  uint64_t totalVoltageSqr; /*!< Running total of the squares in ADC counts - exact, so it never drifts */
+  int64_t fundamentalRe; /*!< Real part of the fundamental DFT bin of the window, ADC counts Q15 - exact */
+  int64_t fundamentalIm; /*!< Imaginary part of the fundamental DFT bin of the window, ADC counts Q15 - exact */
+#endif
+  uint8_t head; /*!< Index of the oldest sample, which is the next one to be overwritten */
 }TChannelData;
 
+#define FREQUENCY_CYCLES     8 /*!< Number of cycles averaged by the frequency estimator */
+#define FREQUENCY_HYSTERESIS 64 /*!< ADC counts the waveform has to go under zero by before a rising crossing counts */
+#define FREQUENCY_TIMEOUT    ((uint32_t) (2 * FREQUENCY_CYCLES * NB_SAMPLES) << 16) /*!< Crossings lost if the estimate takes longer, Q16 samples */
+
+typedef struct
+{
+  int16_t lastSample;  /*!< Previous sample, in ADC counts */
+  bool armed;          /*!< TRUE once the waveform went under -FREQUENCY_HYSTERESIS since the last crossing */
+  bool started;        /*!< TRUE once the first crossing of the estimate has been found */
+  uint8_t cycles;      /*!< Rising crossings found since the first one */
+  uint32_t time;       /*!< Time of the current sample since the first crossing, in samples Q16 */
+  uint32_t period;     /*!< Average period of the last estimate, in samples Q16 */
+  int32_t phase;       /*!< Offset of the last crossing from the nearest sample, in samples Q16 */
+}TFrequencyTracker;
+
+#define PLL_PHASE_SHIFT      3 /*!< The sample clock corrects 1/2^3 of the phase error per estimate */
+#define PLL_MAX_STEP         (SAMPLE_PERIOD / 200) /*!< Largest change of the sample period per estimate, in ns */
+
 typedef struct
 {
-  uint8_t crossing1;
-  uint8_t crossing2;
-}TCrossing;
+  uint64_t sumSqr; /*!< Sum of the squares of the samples */
+  int32_t sum;     /*!< Sum of the samples */
+  int16_t min;     /*!< Smallest sample */
+  int16_t max;     /*!< Biggest sample */
+}TBlockStats;
 
 #define ADC_RATE            3276.7 // Convert 16 bit high and low to +-10V
 #define ANALOG_TO_VOLT(X)   (float) X / (float) ADC_RATE
@@ -35,51 +102,179 @@ typedef enum
   EXTREMELY_INVERSE
 }TCharacteristic;
 
-TCharacteristic Current_Charac; // Keeping track of the current mode INVERSE, VERY INVERSE, EXTREMELY INVERSE
+#define IDMT_SETTING        1000 /*!< Current setting Is of the IDMT curves, in mA */
+#define IDMT_TMS            1.0f /*!< Time multiplier setting of the IDMT curves */
+#define IDMT_OCTAVE_MIN     4 /*!< I - Is starts at 2^4 mA in the IDMT table */
+#define IDMT_OCTAVE_MAX     15 /*!< I - Is ends at 2^15 mA in the IDMT table */
+#define IDMT_STEPS_BITS     4 /*!< Each octave of the IDMT table has 2^4 steps */
+#define IDMT_STEPS          (1 << IDMT_STEPS_BITS)
+#define IDMT_TABLE_SIZE     (((IDMT_OCTAVE_MAX - IDMT_OCTAVE_MIN) << IDMT_STEPS_BITS) + 1)
+#define IDMT_DELTA_MIN      (1 << IDMT_OCTAVE_MIN) /*!< Smallest I - Is in mA, below that the trip time is clamped */
+#define IDMT_DELTA_MAX      (1 << IDMT_OCTAVE_MAX) /*!< Biggest I - Is in mA, above that the trip time is clamped */
+
+typedef enum
+{
+  IDMT_ALPHA_0_02,
+  IDMT_ALPHA_1,
+  IDMT_ALPHA_2
+}TIDMTAlpha;
+
+typedef struct
+{
+  float k;          /*!< Constant k of the characteristic, in s */
+  TIDMTAlpha alpha; /*!< Exponent alpha of the characteristic */
+}TIDMTCurve;
+
+extern TCharacteristic Current_Charac; // Keeping track of the current mode INVERSE, VERY INVERSE, EXTREMELY INVERSE
+
+#define TRIP_ONE            0x80000000u /*!< 1.0 in Q31 - a trip element trips when its accumulator reaches it */
+#define TRIP_RESET_TIME     1000 /*!< Time for a full accumulator to decay back to 0 in TRIP_RESET_DECAY mode, in ms */
+
+typedef enum
+{
+  TRIP_RESET_INSTANT, /*!< Accumulator goes back to 0 as soon as the current is under pickup */
+  TRIP_RESET_DECAY    /*!< Accumulator decays linearly to 0 in TRIP_RESET_TIME when the current is under pickup */
+}TTripReset;
+
+extern TTripReset Current_Reset; // Keeping track of the reset behaviour of the trip elements
+
+typedef struct
+{
+  uint32_t accumulator; /*!< Fraction of the trip time elapsed, Q31 */
+  uint32_t increment;   /*!< Fraction of the trip time of one sample at the current below, Q31 */
+  TCurrent current;     /*!< Current the increment has been calculated for */
+  TCharacteristic charac; /*!< Characteristic the increment has been calculated for */
+}TTripElement;
 
 
-/*! @brief Keeps the 16 samples of voltages, voltages square and running total of the square
+/*! @brief Keeps the last NB_SAMPLES voltages, voltages square and running total of the square
  *
- * @param data - newest sample taken by uC
+ *  The oldest sample is overwritten in place and the head moves forward, so adding a sample is O(1).
+ * @param data - newest sample taken by uC, in ADC counts
  * @param channelData - tracking of indepedent voltages for each channel
  */
-void Sliding_voltage(float data,TChannelData* channelData);
+void Sliding_voltage(int16_t data,TChannelData* channelData);
 
 /*! @brief Returns the voltage RMS, calculated from global variable totalVoltageSqr
  *
  *  @param channelData - tracking of indepedent voltages for each channel
  *
- *  @return float - value of voltage RMS
+ *  @return TVoltage - value of voltage RMS
  */
-float Real_RMS(TChannelData* channelData);
+TVoltage Real_RMS(TChannelData* channelData);
+
+/*! @brief Returns the RMS of the fundamental, calculated from the sliding DFT of the window
+ *
+ *  The DFT bin is updated by Sliding_voltage with two multiply-adds per sample. With NB_SAMPLES
+ *  samples per cycle it rejects the DC offset and the harmonics.
+ *  @param channelData - tracking of indepedent voltages for each channel
+ *  @return TVoltage - value of the fundamental voltage RMS, in the same unit as Real_RMS
+ */
+TVoltage Fundamental_RMS(TChannelData* channelData);
+
+/*! @brief Returns the angle of the fundamental phasor at the newest sample
+ *
+ *  @param channelData - tracking of indepedent voltages for each channel
+ *  @return float - angle in radians, between -pi and pi
+ */
+float Fundamental_Angle(TChannelData* channelData);
 
 /*! @brief Converts voltage RMS to current RMS
  *
  *  @param voltageRMS - voltageRMS to be converted 
- *  @return float - current RMS
+ *  @return TCurrent - current RMS
  */
-float Current_RMS(float voltageRMS);
+TCurrent Current_RMS(TVoltage voltageRMS);
+
+/*! @brief Clears the sliding window of a channel
+ *
+ *  @param channelData - channel to be cleared
+ */
+void Reset_Channel(TChannelData* channelData);
 
 
 /*! @brief Calculates the goal to reach before tripping the circuit 
  *
+ *  Evaluates the IEC 60255 curve of Current_Charac. Integer exponents are calculated exactly
+ *  and (I/Is)^0.02 is interpolated from a log spaced table.
  *  @param currentRMS - current that corresponds to the trip goal to reach
- *  @return uint32_t - goal to reach
+ *  @return uint32_t - goal to reach, in number of samples
+ */
+uint32_t Calculate_TripGoal(TCurrent currentRMS);
+
+/*! @brief Integrates one sample into an IDMT trip element
+ *
+ *  Above pickup each sample adds sample period / trip time to the accumulator, so a fluctuating
+ *  current trips when the time spent at each current adds up to its share of the curve.
+ *  The trip time is only evaluated again when the current changes.
+ *  @param element - trip element of the channel
+ *  @param currentRMS - current RMS of the channel for this sample
+ *  @return bool - TRUE if the accumulator has reached TRIP_ONE
+ */
+bool Update_Trip(TTripElement* const element, const TCurrent currentRMS);
+
+/*! @brief Clears a trip element, after the breaker has been reset
+ *
+ *  @param element - trip element to be cleared
+ */
+void Reset_Trip(TTripElement* const element);
+
+/*! @brief Calculates the sum of squares, sum, min and max of a block of samples in one pass
+ *
+ *  Uses the Cortex-M4 dual 16 bit multiply-accumulate instructions when available,
+ *  and a portable loop otherwise (e.g. when built on a PC).
+ *  @param samples - block of samples in ADC counts, in any order
+ *  @param nbSamples - number of samples in the block
+ *  @param stats - statistics of the block
  */
-uint32_t Calculate_TripGoal(float currentRMS);
+void Block_Stats(const int16_t samples[], const uint16_t nbSamples, TBlockStats* const stats);
 
-/*! @brief Checks for zero crossings
+/*! @brief Returns the voltage RMS of a number of samples from the sum of their squares
  *
+ *  Used for windows longer than NB_SAMPLES, e.g. with sums of squares from Block_Stats.
+ *  @param sumSqr - sum of the squares of the samples, in ADC counts
+ *  @param nbSamples - number of samples summed
+ *  @return TVoltage - value of voltage RMS
+ */
+TVoltage Mean_RMS(const uint64_t sumSqr, const uint32_t nbSamples);
+
+/*! @brief Tracks the rising zero crossings of a channel, one sample at a time
  *
- *  @return bool - TRUE if found zero crossings
+ *  The time of each crossing is linearly interpolated between the two samples around it,
+ *  and the period is averaged over FREQUENCY_CYCLES cycles, so the window is never scanned again.
+ *  @param tracker - frequency tracker of the channel
+ *  @param sample - newest sample taken by uC, in ADC counts
+ *  @return bool - TRUE if a new average period is available in the tracker
  */
-bool Zero_Crossings(float sample[], TCrossing* crossing);
+bool Update_Frequency(TFrequencyTracker* const tracker, const int16_t sample);
 
-/*! @brief Calculates the frequency and set PIT from the crossings
+/*! @brief Abandons the estimate in progress, after samples have been skipped
  *
+ *  @param tracker - frequency tracker to be restarted from the next crossing
+ */
+void Reset_Frequency(TFrequencyTracker* const tracker);
+
+/*! @brief Calculates the frequency from the average period
+ *
+ *  @param tracker - frequency tracker with a new average period
+ *  @return float - frequency in Hz, 0 if it is not between 47.5 and 52.5Hz
+ */
+float Calculate_Frequency(const TFrequencyTracker* const tracker);
+
+/*! @brief Steers the sample clock towards NB_SAMPLES samples per cycle, in phase with the crossings
+ *
+ *  The sample period is moved towards NB_SAMPLES samples per cycle, plus a fraction of the phase error
+ *  so the crossings line up with samples, and the step is rate limited. The PIT is never restarted:
+ *  the new period is loaded at the next timeout, so there are no phase jumps in the samples.
+ *  @param tracker - frequency tracker with a new average period, of the one channel the clock follows
+ *  @note The phases are 120 degrees apart, so steering from more than one channel makes them fight each other.
+ */
+void Adjust_SampleClock(const TFrequencyTracker* const tracker);
+
+/*! @brief Gets the sample period the PIT is set to, which follows the frequency
  *
- *  @return bool - TRUE if frequency has been set and is between 47.5 and 52.5Hz
+ *  @return uint32_t - sample period in ns
  */
-float Calculate_Frequency(TCrossing* crossing);
+uint32_t Get_SamplePeriod(void);
 
-//
+#endif
@@ -0,0 +1,197 @@
+/*! @file
+ *
+ *  @brief Routines to handle the DOR commands of the PC, which read and set the protection and its diagnostics.
+ *
+ *  This contains the functions for handling the DOR commands.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup dor_module dor module documentation
+**  @{
+*/
+
+#include "dor.h"
+#include "packet.h"
+#include "calculation.h"
+#include "acquisition.h"
+#include "protection.h"
+#include "metering.h"
+#include "tripreport.h"
+#include "overrun.h"
+#include "profile.h"
+#include "telemetry.h"
+
+static bool DORPackets(const TPacket* const packet);
+
+
+bool DOR_Init(void)
+{
+  return Packet_Register(DOR_COMMAND, DORPackets);
+}
+
+
+/*! @brief Handles the DOR command packets
+ *
+ *  @param packet - packet taken off the packet queue
+ *  @return bool - TRUE if packet has been sent and handled successfully
+ *  @note Registered for DOR_COMMAND by DOR_Init
+ */
+static bool DORPackets(const TPacket* const packet)
+{
+  uint32_t profileTimes[3]; // Min, average and max time of a stage when sending packet
+  TCriticalStats criticalStats; // Histogram and max time of a critical section when sending packet
+  TTripReport tripReport; // Error histogram and last trip times of a characteristic when sending packet
+  uint32_t overruns[DOR_OVERRUN_DROPPED + 1]; // Overruns per stage, metering skips and dropped frames when sending packet
+  uint32_t centiCurrent; // To store the current in hundredths of A when sending packet
+  float decimalFrequency; // To store the decimal part of the frequency when sending packet
+  float frequency; // Copy of the last estimate of the metering thread
+  TPacketStats commandStats; // Invocations, failures and handler times of a command when sending packet
+  bool success = true; // Replies of more than one packet succeed only if every packet was queued
+  switch (Packet_Parameter1(packet))
+  {
+    case DOR_IDMT_CHAR:
+      if (Packet_Parameter2(packet) == DOR_IDMT_GET)
+      {
+  /*GET IDMT CHARACTERISTICS*/
+        return Packet_Put(DOR_COMMAND, DOR_IDMT_CHAR, DOR_IDMT_GET, Current_Charac);
+      }
+      else if (Packet_Parameter2(packet) == DOR_IDMT_SET)
+      {
+  /*SET IDMT CHARACTERISTICS */
+        if (Packet_Parameter3(packet) > EXTREMELY_INVERSE)
+          return false; // Out of the curve table
+        Current_Charac = Packet_Parameter3(packet); // The trip elements recalculate their increment on the next sample
+//        Flash_Write8((volatile uint8_t *) CharacFlash, Current_Charac);
+        return Packet_Put(DOR_COMMAND, DOR_IDMT_CHAR, DOR_IDMT_GET, Current_Charac);
+      }
+      return false;
+
+
+    case DOR_GET_CURRENTS:
+      // convert  the current RMS and ouputting it as a packet. MSB is the int part and LSB the float part
+      for (uint8_t channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+      {
+        centiCurrent = CURRENT_TO_CENTIAMPS(Protection.currentRMS[channelNb]);
+        success &= Packet_Put(DOR_COMMAND_CURRENT, channelNb, (uint8_t) (centiCurrent % 100), (uint8_t) (centiCurrent / 100));
+      }
+      return success;
+
+    case DOR_GET_FREQUENCY:
+      // convert the frequency and outputting it as a packet. MSB is the int part and LSB is the decimal part
+      frequency = Metering.frequency; // Written by the metering thread
+      decimalFrequency =  (frequency - ((uint8_t) (frequency)))*100;
+      return Packet_Put(DOR_COMMAND, 2, (uint8_t) (decimalFrequency), (uint8_t) frequency);
+
+    case DOR_GET_TRIPPED:
+      //Send the packet including the number of times tripped
+      return Packet_Put(DOR_COMMAND, DOR_GET_TRIPPED,   NumberTripped.s.Lo,   NumberTripped.s.Hi);
+
+    case DOR_GET_FAULT:
+      // The fault type is not recorded, so there is nothing to reply with
+      return false;
+
+    case DOR_GET_PROFILE:
+      // Min, average and max time of the stage Parameter2, saturated to 16 bits. Parameter1 of the reply is the stage and the statistic
+      if (!Profile_Get(Packet_Parameter2(packet), &profileTimes[DOR_PROFILE_MIN], &profileTimes[DOR_PROFILE_AVG], &profileTimes[DOR_PROFILE_MAX]))
+        return false;
+      for (uint8_t statistic = DOR_PROFILE_MIN; statistic <= DOR_PROFILE_MAX; statistic++)
+      {
+        uint16union_t time;
+        time.l = (profileTimes[statistic] > 0xFFFF) ? 0xFFFF : profileTimes[statistic];
+        success &= Packet_Put(DOR_COMMAND_PROFILE, (statistic << 4) | Packet_Parameter2(packet), time.s.Lo, time.s.Hi);
+      }
+      return success;
+
+    case DOR_GET_CRITICAL:
+      // Histogram of the times the interrupts were masked at the call site Parameter2, then the longest time, saturated to 16 bits
+      if (!Profile_GetCritical(Packet_Parameter2(packet), &criticalStats))
+        return false;
+      for (uint8_t statistic = 0; statistic <= DOR_CRITICAL_MAX; statistic++)
+      {
+        uint32_t value = (statistic == DOR_CRITICAL_MAX) ? criticalStats.max : criticalStats.histogram[statistic];
+        uint16union_t saturated;
+        saturated.l = (value > 0xFFFF) ? 0xFFFF : value;
+        success &= Packet_Put(DOR_COMMAND_CRITICAL, (statistic << 4) | Packet_Parameter2(packet), saturated.s.Lo, saturated.s.Hi);
+      }
+      return success;
+
+    case DOR_GET_TRIP_REPORT:
+      // Trip time error histogram of the characteristic Parameter2, then the last actual and expected trip times in ms, saturated to 16 bits
+      if (!TripReport_Get(Packet_Parameter2(packet), &tripReport))
+        return false;
+      for (uint8_t statistic = 0; statistic <= DOR_TRIP_REPORT_EXPECTED; statistic++)
+      {
+        uint32_t value;
+        if (statistic == DOR_TRIP_REPORT_ACTUAL)
+          value = tripReport.actual / 1000;
+        else if (statistic == DOR_TRIP_REPORT_EXPECTED)
+          value = tripReport.expected / 1000;
+        else
+          value = tripReport.histogram[statistic];
+        uint16union_t saturated;
+        saturated.l = (value > 0xFFFF) ? 0xFFFF : value;
+        success &= Packet_Put(DOR_COMMAND_TRIP_REPORT, (statistic << 4) | Packet_Parameter2(packet), saturated.s.Lo, saturated.s.Hi);
+      }
+      return success;
+
+    case DOR_GET_OVERRUNS:
+      // Frames past their deadline in each stage, frames the metering was skipped on and frames dropped, saturated to 16 bits
+      for (uint8_t stage = 0; stage < OVERRUN_NB_STAGES; stage++)
+        overruns[stage] = Overrun_Get(stage);
+      overruns[DOR_OVERRUN_SKIPPED] = Overrun_Skipped();
+      overruns[DOR_OVERRUN_DROPPED] = Acquisition_Dropped();
+      for (uint8_t statistic = 0; statistic <= DOR_OVERRUN_DROPPED; statistic++)
+      {
+        uint16union_t saturated;
+        saturated.l = (overruns[statistic] > 0xFFFF) ? 0xFFFF : overruns[statistic];
+        success &= Packet_Put(DOR_COMMAND_OVERRUN, statistic, saturated.s.Lo, saturated.s.Hi);
+      }
+      return success;
+
+    case DOR_DEGRADE:
+      if (Packet_Parameter2(packet) == DOR_DEGRADE_SET)
+      {
+        if (Packet_Parameter3(packet) > DEGRADE_SKIP_METERING)
+          return false;
+        Current_Degrade = Packet_Parameter3(packet);
+      }
+      return Packet_Put(DOR_COMMAND, DOR_DEGRADE, DOR_DEGRADE_GET, Current_Degrade);
+
+    case DOR_TELEMETRY:
+      // Subscribing to the telemetry frames, sent every Parameter3 cycles until set back to 0
+      if (Packet_Parameter2(packet) == DOR_TELEMETRY_SET)
+        Telemetry_Subscribe(Packet_Parameter3(packet));
+      return Packet_Put(DOR_COMMAND, DOR_TELEMETRY, DOR_TELEMETRY_GET, Telemetry_Period());
+
+    case DOR_GET_COMMAND_STATS:
+      // Invocations, failures, average and longest handler time of the command Parameter2, saturated to 16 bits
+      if (!Packet_GetStats(Packet_Parameter2(packet), &commandStats))
+        return false;
+      for (uint8_t statistic = DOR_COMMAND_STATS_INVOCATIONS; statistic <= DOR_COMMAND_STATS_MAX; statistic++)
+      {
+        uint64_t value;
+        if (statistic == DOR_COMMAND_STATS_INVOCATIONS)
+          value = commandStats.invocations;
+        else if (statistic == DOR_COMMAND_STATS_FAILURES)
+          value = commandStats.failures;
+        else if (statistic == DOR_COMMAND_STATS_AVG)
+          value = commandStats.invocations ? (commandStats.totalTime / commandStats.invocations) : 0;
+        else
+          value = commandStats.maxTime;
+        uint16union_t saturated;
+        saturated.l = (value > 0xFFFF) ? 0xFFFF : value;
+        success &= Packet_Put(DOR_COMMAND_STATS, statistic, saturated.s.Lo, saturated.s.Hi);
+      }
+      return success;
+
+    default:
+      return false;
+  }
+}
+
+/*!
+* @}
+*/
@@ -0,0 +1,25 @@
+/*! @file
+ *
+ *  @brief Routines to handle the DOR commands of the PC, which read and set the protection and its diagnostics.
+ *
+ *  The module registers its handler for DOR_COMMAND when it is initialized.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef DOR_H
+#define DOR_H
+
+// new types
+#include "types.h"
+
+extern uint16union_t NumberTripped; // Incremented by the trip output in main
+
+/*! @brief Registers the handler of the DOR commands.
+ *
+ *  @return bool - TRUE if the handler was successfully registered.
+ */
+bool DOR_Init(void);
+
+#endif
@@ -44,36 +44,38 @@
 #include "LEDs.h"
 #include "FTM.h"
 #include "calculation.h"
+#include "acquisition.h"
+#include "protection.h"
+#include "tripreport.h"
+#include "overrun.h"
+#include "trip.h"
+#include "metering.h"
+#include "dor.h"
+#include "profile.h"
 
 // Global variables and macro definitions
 const uint32_t BAUDRATE = 115200; /*!< Baud Rate specified in project */
 const uint32_t MODULECLK = CPU_BUS_CLK_HZ; /*!< Clock Speed referenced from Cpu.H */
 const uint16_t STUDENT_ID = 0x22E2; /*!< Student Number: 7533 */
-const uint8_t PACKET_ACK_MASK = 0x80; /*!< Packet Acknowledgment mask, referring to bit 7 of the Packet */
 static volatile uint16union_t *TowerNumber; /*!< declaring static TowerNumber Pointer */
 static volatile uint16union_t *TowerMode; /*!< declaring static TowerMode Pointer */
 static volatile uint16union_t *Tripped; /*!< declaring static TowerMode Pointer */
 static volatile uint8_t *CharacFlash;
 uint16union_t NumberTripped;
 const uint32_t PIT_Period = 1000000000; /*!< 1 second in nano */
-bool ResetMode;
-float Frequency;
+volatile bool ResetMode; /*!< Set by the LPTimer ISR, cleared by the sampler thread */
 
 
 
 
 // Prototypes functions
 bool TowerInit(void);
-void PacketHandler(void);
-bool StartupPackets(void);
-bool VersionPackets(void);
-bool TowerNumberPackets(void);
-bool TowerModePackets(void);
-bool TowerTimePackets(void);
-bool ProgramBytePackets(void);
-bool ReadBytePackets(void);
-bool DORPackets (void);
+bool StartupPackets(const TPacket* const packet);
+bool VersionPackets(const TPacket* const packet);
+bool TowerNumberPackets(const TPacket* const packet);
+bool TowerModePackets(const TPacket* const packet);
 void PIT0Callback(void);
+void TripOutput(void* pData);
 
 
 // ----------------------------------------
@@ -81,67 +83,40 @@ void PIT0Callback(void);
 // ----------------------------------------
 // Arbitrary thread stack size - big enough for stacking of interrupts and OS use.
 #define THREAD_STACK_SIZE 100
-#define NB_ANALOG_CHANNELS 3
 
 OS_ECB* PacketHandlerSemaphore; //Declare a semaphore, to be signaled.
 
-TChannelData ChannelsData[NB_ANALOG_CHANNELS]; // keeping track of voltages of each channel independently
-
 // Thread stacks
 OS_THREAD_STACK(InitModulesThreadStack, THREAD_STACK_SIZE); /*!< The stack for the LED Init thread. */
-static uint32_t AnalogThreadStacks[NB_ANALOG_CHANNELS][THREAD_STACK_SIZE] __attribute__ ((aligned(0x08)));
+OS_THREAD_STACK(SamplerStack, THREAD_STACK_SIZE);
+OS_THREAD_STACK(MeteringStack, THREAD_STACK_SIZE);
 OS_THREAD_STACK(UARTRXStack, THREAD_STACK_SIZE);
 OS_THREAD_STACK(UARTTXStack, THREAD_STACK_SIZE);
+OS_THREAD_STACK(PacketReceiverStack, THREAD_STACK_SIZE);
 OS_THREAD_STACK(PacketHandlerStack, THREAD_STACK_SIZE);
-OS_THREAD_STACK(PIT0Stack, THREAD_STACK_SIZE);
 
 // ----------------------------------------
 // Thread priorities
 // 0 = highest priority
 // ----------------------------------------
-const uint8_t ANALOG_THREAD_PRIORITIES[NB_ANALOG_CHANNELS] = { 3, 4, 5};
-
-/*! @brief Data structure used to pass Analog configuration to a user thread
- *
- */
-typedef struct AnalogThreadData
-{
-  OS_ECB* semaphore;
-  uint8_t channelNb;
-} TAnalogThreadData;
-
-/*! @brief Analog thread configuration data
- *
- */
-static TAnalogThreadData AnalogThreadData[NB_ANALOG_CHANNELS] =
-{
-  {
-    .semaphore = NULL,
-    .channelNb = 0
-  },
-  {
-    .semaphore = NULL,
-    .channelNb = 1
-  },
-  {
-    .semaphore = NULL,
-    .channelNb = 2
-  }
-};
+const uint8_t SAMPLER_THREAD_PRIORITY = 3;
+const uint8_t METERING_THREAD_PRIORITY = 6;
 
 /*! @brief The Packet Handler Thread
  *
- *  @note - Loops until interrupted by thread of higher priority
+ *  @note - Blocks on the receive FIFO between packets
  */
 void PacketHandlerThread(void* pData)
 {
+  TPacket packet; /*!< This thread's own copy, the receiver keeps decoding into the queue meanwhile */
+
   OS_SemaphoreWait(PacketHandlerSemaphore, 0); //Wait until triggered by Semaphore Signal
-  StartupPackets();
+  StartupPackets(NULL);
   for(;;)
   {
-    if (Packet_Get())
+    if (Packet_Wait(&packet, 0)) // Sleeps until a packet is queued by the receiver thread
     {
-      PacketHandler(); /*!<  When a complete packet is finally formed, handle the packet accordingly */
+      Packet_Handle(&packet); /*!<  Dispatching the packet to the handler its module registered for the command */
     }
   }
 }
@@ -198,18 +173,7 @@ void __attribute__ ((interrupt)) LPTimer_ISR(void)
   // Clear interrupt flag
   LPTMR0_CSR |= LPTMR_CSR_TCF_MASK;
   LPTMR0_CSR &= ~LPTMR_CSR_TEN_MASK;
-  ResetMode = true;
-  for (uint8_t analogNb = 0; analogNb < NB_ANALOG_CHANNELS; analogNb++)
-  {
-    ChannelsData[analogNb].totalVoltageSqr = 0;
-    ChannelsData[analogNb].currentRMS = 0;
-    ChannelsData[analogNb].voltageRMS = 0;
-    for(uint8_t i = 0; i < 16; i++)
-    {
-      ChannelsData[analogNb].voltage[i] = 0;
-      ChannelsData[analogNb].voltageSqr[i] = 0;
-    }
-  }
+  ResetMode = true; // The sampler thread resets the channels, it is the only one writing them
   OS_ISRExit(); //Exit Interrupt
   
 }
@@ -223,16 +187,19 @@ static void InitModulesThread(void* pData)
   // Analog
   (void)Analog_Init(CPU_BUS_CLK_HZ);
 
-  // Generate the global analog semaphores
-  for (uint8_t analogNb = 0; analogNb < NB_ANALOG_CHANNELS; analogNb++)
-    AnalogThreadData[analogNb].semaphore = OS_SemaphoreCreate(0);
-
   LPTMRInit(1000); // Set the Low power timer to a period of 1 second
+  Profile_Init(); // Start the cycle counter used to time the sample processing
+  Acquisition_Init(); // Blocks of samples are timestamped with the cycle counter
+  Metering_Init(); // One snapshot per cycle is handed over to the metering thread
+  Trip_Init(TripOutput); // The trip output is asserted by an FTM0 output compare at the deadline of the curve
   Current_Charac = INVERSE; // Set the default mode to inverse
+  Current_Reset = TRIP_RESET_INSTANT; // Restart the IDMT timing as soon as the fault clears
+  Current_Measurement = MEASUREMENT_RMS; // Protect on the true RMS by default
+  Current_Degrade = DEGRADE_SKIP_METERING; // Under overload, give up the frequency before the protection
   TowerInit(); // Initialise tower modules used in previous labs
   Analog_Put(0, 0); 
   Analog_Put(1, 0);
-  PIT_Set(1250000, true, 0); // Set the sample period to 1.25 ms
+  PIT_Set(SAMPLE_PERIOD, true, 0); // Set the sample period to 1.25 ms for 16 samples per cycle
   OS_EnableInterrupts();
   while (OS_SemaphoreSignal(PacketHandlerSemaphore) != OS_NO_ERROR); // Signal Packet Handler Thread 
 
@@ -240,86 +207,86 @@ static void InitModulesThread(void* pData)
   OS_ThreadDelete(OS_PRIORITY_SELF);
 }
 
-/*! @brief Samples a value on an ADC channel and sends it to the corresponding DAC channel.
+/*! @brief Runs the protection on every frame taken off the acquisition queue, for all the channels.
  *
+ *  @note This thread is the only writer of the protection state, so the processing runs with interrupts enabled.
  */
-void AnalogLoopbackThread(void* pData)
+void SamplerThread(void* pData)
 {
-  // Make the code easier to read by giving a name to the typecast'ed pointer
-  #define analogData ((TAnalogThreadData*)pData)
-
-
-  static uint32_t oldCurrent[NB_ANALOG_CHANNELS];
-  static uint32_t counterTrip[NB_ANALOG_CHANNELS];
-  static uint32_t goalTrip[NB_ANALOG_CHANNELS];
-  static uint32_t oldGoal[NB_ANALOG_CHANNELS];
+  TSampleFrame frame;
 
   for (;;)
   {
-    (void) OS_SemaphoreWait(analogData->semaphore, 0);
-    int16_t analogInputValue;
-    OS_DisableInterrupts();
-    // Get analog sample
-    Analog_Get(analogData->channelNb, &analogInputValue); 
-    if (ResetMode)
-    {
-      // Resetting the circuit breaker and the code after tripping 
-      counterTrip[0] = counterTrip[2] = counterTrip[1] = 0;
-      goalTrip[0] = goalTrip[1] = goalTrip[2] = 0;
-      LEDs_Off(LED_GREEN);
-      LEDs_Off(LED_BLUE);
-      ResetMode = false;
-    }
-    Sliding_voltage(ANALOG_TO_VOLT(analogInputValue), &ChannelsData[analogData->channelNb]); // Adding the new sample value to the structure
-    ChannelsData[analogData->channelNb].voltageRMS = Real_RMS(&ChannelsData[analogData->channelNb]); // Calculate voltage RMS of the last 16 samples
-    ChannelsData[analogData->channelNb].currentRMS =  Current_RMS(ChannelsData[analogData->channelNb].voltageRMS); // Finding and storing the current RMS in the structure
-    if (ChannelsData[analogData->channelNb].currentRMS > 1.03) //&& (oldCurrent != (uint32_t) ChannelsData[analogData->channelNb].currentRMS*100)
+    Acquisition_Wait();
+    while (Acquisition_Get(&frame))
     {
-      if ((ChannelsData[analogData->channelNb].currentRMS != oldCurrent[analogData->channelNb]) || (!goalTrip[analogData->channelNb]))
+      if (ResetMode)
       {
-        goalTrip[analogData->channelNb] = Calculate_TripGoal(ChannelsData[analogData->channelNb].currentRMS); // Calculate the goal to reach before tripping
-        if(oldGoal[analogData->channelNb])
-          counterTrip[analogData->channelNb] = (uint32_t) (((float) (counterTrip[analogData->channelNb]))/ ((float) (oldGoal[analogData->channelNb])))*100/(goalTrip[analogData->channelNb]);
-        oldGoal[analogData->channelNb] = goalTrip[analogData->channelNb];
+        // Resetting the circuit breaker and the code after tripping 
+        Protection_Reset();
+        Trip_Reset();
+        LEDs_Off(LED_GREEN);
+        LEDs_Off(LED_BLUE);
+        ResetMode = false;
       }
-      oldCurrent[analogData->channelNb] = ChannelsData[analogData->channelNb].currentRMS;
 
-
-      Analog_Put(0, VOLT_TO_ANALOG(5)); // Detecting a currentRMS over 1.03, outputting in time channel
-      LEDs_On(LED_BLUE); // Using LED so don't have to check on DSO
-      counterTrip[analogData->channelNb]++; // Incremetnting the count to reach the goal
-      if (counterTrip[analogData->channelNb] >= goalTrip[analogData->channelNb]) // If goal is reached or beyond
+      bool metering = Overrun_Begin(frame.sequence); // FALSE if the sampler is behind and the policy skips the metering
+      bool tripped;
+      bool pickedUp = Protection_Process(frame.samples, &tripped);
+      Trip_Update(frame.timestamp, tripped); // Arming the trip deadline, or tripping now if it has passed
+      Overrun_Check(OVERRUN_PROTECTION);
+      TripReport_Update(pickedUp, frame.timestamp); // Timing the fault from the first sample over pickup
+      if (pickedUp) // Any currentRMS over 1.03
       {
-        Analog_Put(1, VOLT_TO_ANALOG(5)); // Output in channel 2 after trip "delay"
-        LEDs_On(LED_GREEN); // Using LED to check without DSO
-        LPTMR0_CSR |= LPTMR_CSR_TEN_MASK; // Start timer for reset mode 
-        NumberTripped.l++; // Incrementing the number of time Tripped
-        OS_EnableInterrupts();
-//        Flash_Write16((volatile uint16_t *) Tripped, NumberTripped.l); // Write the number of time tripped to Flash
+        TCritical critical = CRITICAL_ENTER(CRITICAL_ANALOG_PUT); // The analog hardware is shared with the acquisition
+        PROFILE_BEGIN(PROFILE_ANALOG_PUT);
+        Analog_Put(0, VOLT_TO_ANALOG(5)); // Detecting a currentRMS over 1.03, outputting in time channel
+        PROFILE_END(PROFILE_ANALOG_PUT);
+        CRITICAL_EXIT(CRITICAL_ANALOG_PUT, critical);
+        LEDs_On(LED_BLUE); // Using LED so don't have to check on DSO
       }
-      else 
+      else // If no currentRMS is over 1.03, the circuit breaker should not be timing
       {
-        OS_EnableInterrupts();
+        TCritical critical = CRITICAL_ENTER(CRITICAL_ANALOG_PUT);
+        PROFILE_BEGIN(PROFILE_ANALOG_PUT);
+        Analog_Put(0, 0);
+        PROFILE_END(PROFILE_ANALOG_PUT);
+        CRITICAL_EXIT(CRITICAL_ANALOG_PUT, critical);
+        LEDs_Off(LED_BLUE);
       }
+      Overrun_Check(OVERRUN_OUTPUTS);
+
+      if (metering)
+        Metering_Put(&frame); // Copied into the snapshot of the cycle, processed by the metering thread
+      else
+        Metering_Skip(); // The metering of this cycle would span the skipped samples
+      Overrun_Check(OVERRUN_METERING);
     }
-    if (PeriodComplete == 16) // Finding the frequency after every 16 samples, PeriodComplete is incremented in PIT_ISR
-    {
-      TCrossing crossing; // structure that stores the zero crossings of waveform
-      if (Zero_Crossings(ChannelsData[analogData->channelNb].voltage, &crossing))
-        Frequency = Calculate_Frequency(&crossing); // Frequency is a global variable storing the current frequency of the wave
-      OS_EnableInterrupts();
-    }
-    else if (ChannelsData[analogData->channelNb].currentRMS < 1.03) // If the currentRMS in under 1.03, the circuit breaking should not be tripped
-    {
-      Analog_Put(0, 0);
-      LEDs_Off(LED_BLUE);
-      OS_EnableInterrupts();
-    }
-    else 
-      OS_EnableInterrupts();
   }
 }
 
+/*! @brief Asserts the trip output, once per fault.
+ *
+ *  @note Called from the FTM ISR at the trip deadline, or from the sampler thread if the deadline had already passed.
+ */
+void TripOutput(void* pData)
+{
+  TCritical critical = CRITICAL_ENTER(CRITICAL_ANALOG_PUT); // The analog hardware is shared with the acquisition and the sampler thread
+  PROFILE_BEGIN(PROFILE_ANALOG_PUT);
+  Analog_Put(1, VOLT_TO_ANALOG(5)); // Output in channel 2 after trip "delay"
+  PROFILE_END(PROFILE_ANALOG_PUT);
+  CRITICAL_EXIT(CRITICAL_ANALOG_PUT, critical);
+  TCurrent faultCurrent = 0; // The highest current is the one that trips first
+  for (uint8_t channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+    if (Protection.currentRMS[channelNb] > faultCurrent)
+      faultCurrent = Protection.currentRMS[channelNb];
+  TripReport_Trip(faultCurrent); // Comparing the fault to trip time with the curve
+  LEDs_On(LED_GREEN); // Using LED to check without DSO
+  LPTMR0_CSR |= LPTMR_CSR_TEN_MASK; // Start timer for reset mode 
+  NumberTripped.l++; // Incrementing the number of time Tripped
+//  Flash_Write16((volatile uint16_t *) Tripped, NumberTripped.l); // Write the number of time tripped to Flash
+}
+
 /*lint -save  -e970 Disable MISRA rule (6.3) checking. */
 int main(void)
 /*lint -restore Enable MISRA rule (6.3) checking. */
@@ -342,16 +309,19 @@ int main(void)
   while (OS_ThreadCreate(UARTTXThread, NULL, &UARTTXStack[THREAD_STACK_SIZE-1], 2) != OS_NO_ERROR); //UARTTX Thread
 
 
-  // Create threads for 3 analog loopback channels
-  for (uint8_t threadNb = 0; threadNb < NB_ANALOG_CHANNELS; threadNb++)
-  {
-    error = OS_ThreadCreate(AnalogLoopbackThread,
-                            &AnalogThreadData[threadNb],
-                            &AnalogThreadStacks[threadNb][THREAD_STACK_SIZE - 1],
-                            ANALOG_THREAD_PRIORITIES[threadNb]);
-  }
+  // Create the thread sampling all the analog channels
+  error = OS_ThreadCreate(SamplerThread,
+                          NULL,
+                          &SamplerStack[THREAD_STACK_SIZE - 1],
+                          SAMPLER_THREAD_PRIORITY);
 
-  while (OS_ThreadCreate(PIT0Thread, NULL, &PIT0Stack[THREAD_STACK_SIZE-1], 6) != OS_NO_ERROR); //PIT Thread
+  // Create the thread processing the cycles handed over by the sampler thread
+  error = OS_ThreadCreate(MeteringThread,
+                          NULL,
+                          &MeteringStack[THREAD_STACK_SIZE - 1],
+                          METERING_THREAD_PRIORITY);
+
+  while (OS_ThreadCreate(PacketReceiverThread, NULL, &PacketReceiverStack[THREAD_STACK_SIZE-1], 5) != OS_NO_ERROR); //Packet Receiver Thread, decodes while the handler is busy
   while (OS_ThreadCreate(PacketHandlerThread, NULL, &PacketHandlerStack[THREAD_STACK_SIZE-1], 7) != OS_NO_ERROR); //Packet Handler Thread
   PacketHandlerSemaphore = OS_SemaphoreCreate(0);
 
@@ -360,64 +330,6 @@ int main(void)
 }
 
 
-/*! @brief Process the packet that has been received
- *
- *  @note Assumes that Packet_Init and Packet_Get was called
- */
-void PacketHandler(void)
-{ /*!<  Packet Handler used after Packet Get */
-  bool actionSuccess;  /*!<  Acknowledge is false as long as the package isn't acknowledge or if it's not required */
-  switch (Packet_Command & ~PACKET_ACK_MASK)
-  {
-    case TOWER_STARTUP_COMMAND:
-      actionSuccess = StartupPackets();
-      break;
-
-    case TOWER_VERSION_COMMAND:
-      actionSuccess = VersionPackets();
-      break;
-
-    case TOWER_NUMBER_COMMAND:
-      actionSuccess = TowerNumberPackets();
-      break;
-
-    case TOWER_MODE_COMMAND:
-      actionSuccess = TowerModePackets();
-      break;
-
-    case SET_TIME_COMMAND:
-      actionSuccess = TowerTimePackets();
-      break;
-
-    case FLASH_PROGRAM_COMMAND:
-      actionSuccess = ProgramBytePackets();
-      break;
-
-    case FLASH_READ_COMMAND:
-      actionSuccess = ReadBytePackets();
-      break;
-
-    case DOR_COMMAND:
-      actionSuccess = DORPackets();
-      break;
-
-
-  }
-
-  if (Packet_Command & PACKET_ACK_MASK) /*!< if ACK bit is set, need to send back ACK packet if done successfully and NAK packet with bit7 cleared */
-  {
-    if (actionSuccess)
-    {
-      Packet_Put(Packet_Command, Packet_Parameter1, Packet_Parameter2, Packet_Parameter3);
-    }
-    else
-    {
-      Packet_Put((Packet_Command |=PACKET_ACK_MASK),Packet_Parameter1, Packet_Parameter2, Packet_Parameter3);
-    }
-  }
-
-}
-
 /*! @brief saves in Flash the TowerNumber and the TowerMode
  *
  *
@@ -450,16 +362,24 @@ bool TowerInit(void)
 
   }
   PIT_Init(MODULECLK, (void*) &PIT0Callback , NULL);
+  RTC_Init(NULL, NULL); // No seconds interrupt, nothing here waits for it
+  RTC_RegisterCommands();
+  Packet_Register(GET_TOWER_STARTUP, StartupPackets); /*!< The tower configuration commands, the other modules register their own */
+  Packet_Register(GET_TOWER_VERSION, VersionPackets);
+  Packet_Register(TOWER_NUMBER_COMMAND, TowerNumberPackets);
+  Packet_Register(TOWER_MODE_COMMAND, TowerModePackets);
+  DOR_Init();
   return Packet_Init(BAUDRATE, MODULECLK);
 }
 
 
 /*! @brief Send the packets needed on startup
 
+ *  @param packet - packet taken off the packet queue, NULL on startup
  *  @return bool - TRUE if packet has been sent successfully
  *  @note Assumes that Packet_Init was called
  */
-bool StartupPackets(void)
+bool StartupPackets(const TPacket* const packet)
 {
   if (Packet_Put(TOWER_STARTUP_COMMAND, TOWER_STARTUP_PARAMETER1, TOWER_STARTUP_PARAMETER2, TOWER_STARTUP_PARAMETER3))
   {
@@ -471,46 +391,50 @@ bool StartupPackets(void)
       }
     }
   }
+  return false; /*!< One of the packets could not be queued */
 }
 
 /*! @brief Send the tower number packet to the PC
  *
+ *  @param packet - packet taken off the packet queue
  *  @return bool - TRUE if packet has been sent successfully
  *  @note Assumes that Packet_Init was called
  */
-bool TowerNumberPackets(void)
+bool TowerNumberPackets(const TPacket* const packet)
 {
-  if (Packet_Parameter1 == (uint8_t) 1)
+  if (Packet_Parameter1(packet) == (uint8_t) 1)
   {
     // if Parameter1 = 1 - get the tower number and send it to PC
     return Packet_Put(TOWER_NUMBER_COMMAND, TOWER_NUMBER_GET, TowerNumber->s.Lo, TowerNumber->s.Hi);
   }
-  else if (Packet_Parameter1 == (uint8_t) 2) // if Parameter1 =2 - write new TowerNumber to Flash and send it to interface
+  else if (Packet_Parameter1(packet) == (uint8_t) 2) // if Parameter1 =2 - write new TowerNumber to Flash and send it to interface
   {
     uint16union_t newTowerNumber; /*! < create a union variable to combine the two Parameters*/
-    newTowerNumber.s.Lo = Packet_Parameter2;
-    newTowerNumber.s.Hi = Packet_Parameter3;
+    newTowerNumber.s.Lo = Packet_Parameter2(packet);
+    newTowerNumber.s.Hi = Packet_Parameter3(packet);
     Flash_Write16((volatile uint16_t *) TowerNumber, newTowerNumber.l);
     return Packet_Put(TOWER_NUMBER_COMMAND, TOWER_NUMBER_SET, TowerNumber->s.Lo, TowerNumber->s.Hi);
   }
+  return false; /*!< Parameter1 is neither get nor set */
 }
 
 /*! @brief Send the tower mode packet to the PC
  *
+ *  @param packet - packet taken off the packet queue
  *  @return bool - TRUE if packet has been sent successfully
  *  @note Assumes that Packet_Init was called
  */
-bool TowerModePackets(void)
+bool TowerModePackets(const TPacket* const packet)
 {
-  if (Packet_Parameter1 == 1) // if paramater1 = 1 - get the towermode and send it to PC
+  if (Packet_Parameter1(packet) == 1) // if paramater1 = 1 - get the towermode and send it to PC
   {
     return Packet_Put(TOWER_MODE_COMMAND,TOWER_MODE_GET, TowerMode->s.Lo, TowerMode->s.Hi);
   }
-  else if (Packet_Parameter1 == 2) // if parameter1 = 2 - set the towermode, write to Flash and send it back to PC
+  else if (Packet_Parameter1(packet) == 2) // if parameter1 = 2 - set the towermode, write to Flash and send it back to PC
   {
     uint16union_t newTowerMode; /* !< Create a union variable to combine parameter2 and 3*/
-    newTowerMode.s.Lo = Packet_Parameter2;
-    newTowerMode.s.Hi = Packet_Parameter3;
+    newTowerMode.s.Lo = Packet_Parameter2(packet);
+    newTowerMode.s.Hi = Packet_Parameter3(packet);
     Flash_Write16((volatile uint16_t *) TowerMode, newTowerMode.l);
     return Packet_Put(TOWER_MODE_COMMAND,TOWER_MODE_SET, TowerMode->s.Lo, TowerMode->s.Hi);
   }
@@ -520,137 +444,23 @@ bool TowerModePackets(void)
 
 /*! @brief Send the version packet to the PC
  *
+ *  @param packet - packet taken off the packet queue
  *  @return bool - TRUE if packet has been sent successfully
  *  @note Assumes that Packet_Init was called
  */
-bool VersionPackets(void)
+bool VersionPackets(const TPacket* const packet)
 {
   return Packet_Put(TOWER_VERSION_COMMAND,TOWER_VERSION_PARAMETER1,TOWER_VERSION_PARAMETER2, TOWER_VERSION_PARAMETER3);
 }
 
-/*! @brief Handles the packet to program bytes in FLASH
- *
- *  @return bool - TRUE if packet has been sent and handled successfully
- *  @note Assumes that Packet_Init was called
- */
-bool ProgramBytePackets(void)
-{
-  if (Packet_Parameter1 == 8)
-  {
-    return Flash_Erase(); /*! < if Parameter1  = 8 - erase the whole sector */
-  }
-  else if (Packet_Parameter1 > 8)
-  {
-    return false; //data sent is obsolete
-  }
-  else /*!< if offset (Parameter1) is between 0 and 7 inclusive, check the offset */
-  {
-    volatile uint8_t *address = (uint8_t *)(FLASH_DATA_START + Packet_Parameter1);
-    return Flash_Write8(address, Packet_Parameter3); //Write in the Flash
-  }
-  return false;
-}
-
-/*! @brief Handles the packet to read bytes from FLASH
- *
- *  @return bool - TRUE if packet has been sent and handled successfully
- *  @note Assumes that Packet_Init was called
- */
-bool ReadBytePackets(void)
-{
-  uint8_t readByte = _FB(FLASH_DATA_START + Packet_Parameter1); /* !< fetching the Byte at offset Parameter1 and send it to PCc*/
-  return Packet_Put(FLASH_READ_COMMAND, Packet_Parameter1, 0x0, readByte);
-}
-
-
-/*! @brief Handles the packet RTC time - sends back ther packet to PC if setting time is successful
- *
- *  @return bool - TRUE if packet has been sent and handled successfully
- *  @note Assumes that Packet_Init and RTC_Init was called
- */
-bool TowerTimePackets(void)
-{
-  /*!< Checking if input is valid, if not, return false */
-  if (Packet_Parameter1 <= 23)
-  {
-    if (Packet_Parameter2 <= 59)
-    {
-      if (Packet_Parameter3 <= 59)
-      {
-        /*!< sets the time with packet parameters given by PC */
-        RTC_Set(Packet_Parameter1, Packet_Parameter2, Packet_Parameter3);
-        /*!< returns the original packet to the PC if successful */
-        return Packet_Put(SET_TIME_COMMAND, Packet_Parameter1, Packet_Parameter2, Packet_Parameter3);
-      }
-    }
-  }
-  return false;
-}
-
-/*! @brief Handles the DOR command packets
- *
- *  @return bool - TRUE if packet has been sent and handled successfully
- *  @note Assumes that Packet_Init was called
- */
-bool DORPackets (void)
-{
-  float decimalCurrents[NB_ANALOG_CHANNELS]; // To store the decimal part of the current when sending packet
-  float decimalFrequency; // To store the decimal part of the frequency when sending packet
-  switch (Packet_Parameter1)
-  {
-    case DOR_IDMT_CHAR:
-      if (Packet_Parameter2 == DOR_IDMT_GET)
-      {
-  /*GET IDMT CHARACTERISTICS*/
-        return Packet_Put(DOR_COMMAND, DOR_IDMT_CHAR, DOR_IDMT_GET, Current_Charac);
-      }
-      else if (Packet_Parameter2 == DOR_IDMT_SET)
-      {
-  /*SET IDMT CHARACTERISTICS */
-        Current_Charac = Packet_Parameter3;
-//        Flash_Write8((volatile uint8_t *) CharacFlash, Current_Charac);
-        return Packet_Put(DOR_COMMAND, DOR_IDMT_CHAR, DOR_IDMT_GET, Current_Charac);
-      }
-      break;
-
-
-    case DOR_GET_CURRENTS:
-      // convert  the current RMS and ouputting it as a packet. MSB is the int part and LSB the float part
-      decimalCurrents[0] =  (ChannelsData[0].currentRMS - ((uint8_t) (ChannelsData[0].currentRMS)))*100;
-      decimalCurrents[1] =  (ChannelsData[1].currentRMS - ((uint8_t) (ChannelsData[1].currentRMS)))*100;
-      decimalCurrents[2] =  (ChannelsData[2].currentRMS - ((uint8_t) (ChannelsData[2].currentRMS)))*100;
-      Packet_Put(DOR_COMMAND_CURRENT, 0, (uint8_t) (decimalCurrents[0]), (uint8_t) ChannelsData[0].currentRMS);
-      Packet_Put(DOR_COMMAND_CURRENT, 1, (uint8_t) (decimalCurrents[1]), (uint8_t) ChannelsData[1].currentRMS);
-      Packet_Put(DOR_COMMAND_CURRENT, 2, (uint8_t) (decimalCurrents[2]), (uint8_t) ChannelsData[2].currentRMS);
-      break;
-
-    case DOR_GET_FREQUENCY:
-      // convert the frequency and outputting it as a packet. MSB is the int part and LSB is the decimal part
-      decimalFrequency =  (Frequency - ((uint8_t) (Frequency)))*100;
-      Packet_Put(DOR_COMMAND, 2, (uint8_t) (decimalCurrents[2]), (uint8_t) Frequency);
-      break;
-
-    case DOR_GET_TRIPPED:
-      //Send the packet including the number of times tripped
-      Packet_Put(DOR_COMMAND, DOR_GET_TRIPPED,   NumberTripped.s.Lo,   NumberTripped.s.Hi);
-      break;
-
-    case DOR_GET_FAULT:
-      break;
-  }
-}
-
-
-/*! @brief Triggered during interrupt, toggles green LED
- * Signaling the analog thread for each channel A, B and C 
+/*! @brief Triggered every PIT tick, from the PIT ISR
+ * Sampling the channels A, B and C, the sampler thread is signaled once a block is complete
  *
  *  @note Assumes that PIT_Init called
  */
 void PIT0Callback()
 {
-  //Signals the 3 analog threads semaphores
-  for (uint8_t analogNb = 0; analogNb < NB_ANALOG_CHANNELS; analogNb++)
-    OS_SemaphoreSignal(AnalogThreadData[analogNb].semaphore);
+  Acquisition_Sample();
 }
 
 
@@ -0,0 +1,160 @@
+/*! @file
+ *
+ *  @brief Routines of the metering, run once per cycle on blocks of samples handed over by the sampler thread.
+ *
+ *  This contains the functions for operating the metering.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup metering_module metering module documentation
+**  @{
+*/
+
+#include "metering.h"
+#include "OS.h"
+#include "telemetry.h"
+
+TMetering Metering;
+
+static TMeteringSnapshot Snapshots[METERING_QUEUE_SIZE]; /*!< Ring of snapshots, only the producer writes the one at Head */
+static uint32_t Head;         /*!< Snapshots published, written by the sampler thread only */
+static uint32_t Tail;         /*!< Snapshots processed, written by the metering thread only */
+static bool Filling;         /*!< TRUE while the frames of the cycle go to the snapshot at Head */
+static uint32_t NextSequence; /*!< Sequence number of the frame expected next */
+static bool Gap;              /*!< TRUE if frames were missed since the last snapshot published */
+static OS_ECB* MeteringSemaphore; /*!< Signaled once per snapshot published */
+
+static TFrequencyTracker FrequencyTracker; // keeping track of the zero crossings of the reference channel
+
+
+bool Metering_Init(void)
+{
+  Head = 0;
+  Tail = 0;
+  Filling = false;
+  Gap = true; // Nothing to be continuous with yet
+  Metering.frequency = 0;
+  Metering.cycles = 0;
+  Metering.dropped = 0;
+  MeteringSemaphore = OS_SemaphoreCreate(0);
+  return true;
+}
+
+
+void Metering_Put(const TSampleFrame* const frame)
+{
+  uint8_t sampleNb = frame->sequence % NB_SAMPLES; // Snapshots start on a block boundary of the acquisition
+
+  if (frame->sequence != NextSequence)
+  {
+    Gap = true; // Frames were dropped by the acquisition
+    Filling = false;
+  }
+  NextSequence = frame->sequence + 1;
+
+  if (sampleNb == 0)
+  {
+    Filling = ((Head - LOAD_ACQUIRE(Tail)) < METERING_QUEUE_SIZE);
+    if (!Filling)
+    {
+      Metering.dropped++; // No room, the metering thread is behind
+      Gap = true;
+    }
+    else
+      Snapshots[Head & METERING_QUEUE_MASK].sequence = frame->sequence;
+  }
+  if (!Filling)
+    return;
+
+  TMeteringSnapshot* snapshot = &Snapshots[Head & METERING_QUEUE_MASK];
+  for (uint8_t analogNb = 0; analogNb < NB_ANALOG_CHANNELS; analogNb++)
+    snapshot->samples[analogNb][sampleNb] = frame->samples[analogNb];
+
+  if (sampleNb == (NB_SAMPLES - 1))
+  {
+    snapshot->discontinuous = Gap;
+    Gap = false;
+    STORE_RELEASE(Head, Head + 1);
+    (void)OS_SemaphoreSignal(MeteringSemaphore);
+  }
+}
+
+
+void Metering_Skip(void)
+{
+  Gap = true;
+  Filling = false; // The rest of the cycle is given up too
+}
+
+
+void MeteringThread(void* pData)
+{
+  uint64_t sumSqr[NB_ANALOG_CHANNELS]; // Accumulated over METERING_CYCLES cycles
+  int16_t min[NB_ANALOG_CHANNELS];
+  int16_t max[NB_ANALOG_CHANNELS];
+  uint8_t cycles = 0;
+
+  for (;;)
+  {
+    (void)OS_SemaphoreWait(MeteringSemaphore, 0);
+    while (Tail != LOAD_ACQUIRE(Head))
+    {
+      const TMeteringSnapshot* snapshot = &Snapshots[Tail & METERING_QUEUE_MASK];
+      uint32_t sequence = snapshot->sequence;
+
+      if (snapshot->discontinuous)
+      {
+        cycles = 0; // The averages would span the missing samples
+        Reset_Frequency(&FrequencyTracker); // So would the estimate
+      }
+
+      for (uint8_t sampleNb = 0; sampleNb < NB_SAMPLES; sampleNb++)
+        if (Update_Frequency(&FrequencyTracker, snapshot->samples[METERING_FREQUENCY_CHANNEL][sampleNb])) // New average period after every FREQUENCY_CYCLES cycles
+        {
+          Metering.frequency = Calculate_Frequency(&FrequencyTracker);
+          if (Metering.frequency != 0)
+            Adjust_SampleClock(&FrequencyTracker); // Keeping NB_SAMPLES samples per cycle, once per estimate
+        }
+
+      for (uint8_t analogNb = 0; analogNb < NB_ANALOG_CHANNELS; analogNb++)
+      {
+        TBlockStats stats;
+        Block_Stats(snapshot->samples[analogNb], NB_SAMPLES, &stats);
+        if (cycles == 0)
+        {
+          sumSqr[analogNb] = 0;
+          min[analogNb] = stats.min;
+          max[analogNb] = stats.max;
+        }
+        sumSqr[analogNb] += stats.sumSqr;
+        if (stats.min < min[analogNb])
+          min[analogNb] = stats.min;
+        if (stats.max > max[analogNb])
+          max[analogNb] = stats.max;
+      }
+
+      STORE_RELEASE(Tail, Tail + 1); // The snapshot has been read, the sampler can reuse it
+      Metering.cycles++;
+
+      if (++cycles == METERING_CYCLES)
+      {
+        for (uint8_t analogNb = 0; analogNb < NB_ANALOG_CHANNELS; analogNb++)
+        {
+          Metering.currentRMS[analogNb] = Current_RMS(Mean_RMS(sumSqr[analogNb], (uint32_t) METERING_CYCLES * NB_SAMPLES));
+          Metering.min[analogNb] = min[analogNb];
+          Metering.max[analogNb] = max[analogNb];
+        }
+        cycles = 0;
+      }
+
+      Telemetry_Cycle(sequence); // Pushing the measurements to the PC if it subscribed
+    }
+  }
+}
+
+/*!
+* @}
+*/
@@ -0,0 +1,72 @@
+/*! @file
+ *
+ *  @brief Routines of the metering, run once per cycle on blocks of samples handed over by the sampler thread.
+ *
+ *  The protection runs on every sample at the priority of the sampler thread. The metering only needs whole
+ *  cycles, so the sampler copies the frames into a snapshot of one cycle and publishes it once per cycle to a
+ *  thread of lower priority. The snapshots are passed through a single-producer/single-consumer ring; when the
+ *  metering falls behind, the snapshot is dropped and the protection never waits for it.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef METERING_H
+#define METERING_H
+
+// new types
+#include "types.h"
+#include "calculation.h"
+#include "acquisition.h"
+
+#define METERING_QUEUE_SIZE 4  /*!< Snapshots in the ring, must be a power of 2 */
+#define METERING_QUEUE_MASK (METERING_QUEUE_SIZE - 1)
+#define METERING_CYCLES     50 /*!< Cycles averaged by the RMS and the statistics, 1 s at 50 Hz */
+#define METERING_FREQUENCY_CHANNEL 0 /*!< Channel the frequency is measured on and the sample clock follows */
+
+typedef struct
+{
+  uint32_t sequence;                                 /*!< Sequence number of the first frame of the cycle */
+  bool discontinuous;                                /*!< TRUE if frames are missing since the previous snapshot */
+  int16_t samples[NB_ANALOG_CHANNELS][NB_SAMPLES];   /*!< One cycle of each channel, in ADC counts */
+} TMeteringSnapshot;
+
+typedef struct
+{
+  float frequency;                        /*!< Frequency of the last estimate, 0 if out of range */
+  TCurrent currentRMS[NB_ANALOG_CHANNELS]; /*!< Current RMS of each channel over the last METERING_CYCLES cycles */
+  int16_t min[NB_ANALOG_CHANNELS];         /*!< Smallest sample of each channel over the last METERING_CYCLES cycles */
+  int16_t max[NB_ANALOG_CHANNELS];         /*!< Biggest sample of each channel over the last METERING_CYCLES cycles */
+  uint32_t cycles;                         /*!< Number of cycles processed */
+  uint32_t dropped;                        /*!< Number of cycles dropped because the ring was full */
+} TMetering;
+
+extern TMetering Metering; // Keeping track of the slow measurements
+
+/*! @brief Sets up the snapshot ring and clears the measurements.
+ *
+ *  @return bool - TRUE if the metering was successfully initialized.
+ */
+bool Metering_Init(void);
+
+/*! @brief Adds a frame to the snapshot of the current cycle, and publishes the snapshot once it is complete.
+ *
+ *  @param frame - frame taken off the acquisition queue.
+ *  @note Called by the sampler thread only.
+ */
+void Metering_Put(const TSampleFrame* const frame);
+
+/*! @brief Gives up the snapshot of the current cycle.
+ *
+ *  @note Called by the sampler thread when the degradation policy skips the metering of a frame.
+ */
+void Metering_Skip(void);
+
+/*! @brief The metering thread, processing the snapshots of the sampler thread.
+ *
+ *  @param pData - not used.
+ *  @note Runs at a lower priority than the sampler thread.
+ */
+void MeteringThread(void* pData);
+
+#endif
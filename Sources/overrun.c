@@ -0,0 +1,62 @@
+/*! @file
+ *
+ *  @brief Routines to detect when the processing of the samples falls behind the PIT ticks.
+ *
+ *  This contains the functions for operating the deadline accounting.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup overrun_module overrun module documentation
+**  @{
+*/
+
+#include "overrun.h"
+
+TDegradePolicy Current_Degrade;
+
+static uint32_t Overruns[OVERRUN_NB_STAGES]; /*!< Frames past their deadline, per stage */
+static uint32_t Skipped;                     /*!< Frames the metering was skipped on */
+static uint32_t Deadline;                    /*!< Tick the frame being processed is due by */
+static bool Counted;                         /*!< TRUE once the overrun of the frame being processed is counted */
+
+
+bool Overrun_Begin(const uint32_t sequence)
+{
+  Deadline = ((sequence / ACQUISITION_BLOCK_SIZE) + 2) * ACQUISITION_BLOCK_SIZE; // Before the next block is complete
+  Counted = false;
+  if ((Current_Degrade == DEGRADE_SKIP_METERING) && ((int32_t) (Acquisition_Ticks() - Deadline) >= 0))
+  {
+    Skipped++; // The next block is already waiting, the frame is late before being processed
+    return false;
+  }
+  return true;
+}
+
+
+void Overrun_Check(const TOverrunStage stage)
+{
+  if (!Counted && ((int32_t) (Acquisition_Ticks() - Deadline) >= 0)) // Wraps like the tick count
+  {
+    Overruns[stage]++;
+    Counted = true;
+  }
+}
+
+
+uint32_t Overrun_Get(const TOverrunStage stage)
+{
+  return (stage < OVERRUN_NB_STAGES) ? Overruns[stage] : 0;
+}
+
+
+uint32_t Overrun_Skipped(void)
+{
+  return Skipped;
+}
+
+/*!
+* @}
+*/
@@ -0,0 +1,64 @@
+/*! @file
+ *
+ *  @brief Routines to detect when the processing of the samples falls behind the PIT ticks.
+ *
+ *  A frame is due before the block after its own has been acquired, when the sampler thread is woken again.
+ *  The stage that was running when a frame went past its deadline is counted as overrunning.
+ *  When a frame is already late before being processed, the degradation policy can skip the metering
+ *  so the protection catches up and a trip is never delayed.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef OVERRUN_H
+#define OVERRUN_H
+
+// new types
+#include "types.h"
+#include "acquisition.h"
+
+typedef enum
+{
+  OVERRUN_PROTECTION, /*!< Windows, RMS and trip elements */
+  OVERRUN_OUTPUTS,    /*!< DAC outputs, LEDs and trip report */
+  OVERRUN_METERING,   /*!< Handing the frame over to the metering thread */
+  OVERRUN_NB_STAGES
+} TOverrunStage;
+
+typedef enum
+{
+  DEGRADE_NEVER,        /*!< Every stage runs on every frame, however late */
+  DEGRADE_SKIP_METERING /*!< The metering is skipped on frames that are already late */
+} TDegradePolicy;
+
+extern TDegradePolicy Current_Degrade; // Keeping track of what is given up under overload
+
+/*! @brief Starts the deadline accounting of a frame.
+ *
+ *  @param sequence - sequence number of the frame.
+ *  @return bool - TRUE if the metering should run on this frame, FALSE if the policy skips it.
+ */
+bool Overrun_Begin(const uint32_t sequence);
+
+/*! @brief Checks the deadline of the frame after a stage.
+ *
+ *  @param stage - stage that has just finished.
+ *  @note The first stage to finish past the deadline of a frame is the one counted.
+ */
+void Overrun_Check(const TOverrunStage stage);
+
+/*! @brief Gets the number of frames that went past their deadline in a stage.
+ *
+ *  @param stage - stage to get the count of.
+ *  @return uint32_t - number of overruns of the stage.
+ */
+uint32_t Overrun_Get(const TOverrunStage stage);
+
+/*! @brief Gets the number of frames the metering was skipped on.
+ *
+ *  @return uint32_t - number of frames skipped by the degradation policy.
+ */
+uint32_t Overrun_Skipped(void);
+
+#endif
@@ -17,103 +17,164 @@
 #include "packet.h"
 #include "Cpu.h"
 #include "OS.h"
+#include "profile.h"
 
-TPacket Packet;
+static TPacket Queue[PACKET_QUEUE_SIZE]; /*!< Decoded packets waiting to be handled */
+static uint8_t QueueHead; /*!< Index of the next packet to be queued, only written by the receiver thread */
+static uint8_t QueueTail; /*!< Index of the next packet to be handled, shared by the handler threads */
+static OS_ECB* QueueItemsSemaphore; /*!< Count of the packets in the queue */
+static OS_ECB* QueueSpaceSemaphore; /*!< Count of the free places in the queue */
+
+static TPacketHandler Handlers[PACKET_NB_COMMANDS]; /*!< Handler of each command, indexed by the command */
+static TPacketStats Stats[PACKET_NB_COMMANDS]; /*!< Statistics of each command */
 
 
 bool Packet_Init(const uint32_t baudRate, const uint32_t moduleClk)
 {
+  QueueHead = QueueTail = 0;
+  QueueItemsSemaphore = OS_SemaphoreCreate(0);
+  QueueSpaceSemaphore = OS_SemaphoreCreate(PACKET_QUEUE_SIZE);
   return UART_Init(baudRate, moduleClk);
 }
 
-bool Packet_Get(void)
+bool Packet_Get(TPacket* const packet, const uint32_t timeout)
 {
-  static uint8_t packetComplete = 0;
-  uint8_t byteSum; /*!< To check if the checksum is correct */
-  /*!< using switch per Packet videos in Lab Videos by Peter McLean */
-  while (1)
+  uint8_t frame[PACKET_NB_BYTES]; /*!< The bytes are read in place in the receive FIFO, and only copied out once valid */
+  uint32_t deadline = OS_TimeGet() + timeout; /*!< One deadline for the whole call, so bad bytes do not restart the timeout */
+
+  for (;;)
   {
-    switch(packetComplete)
+    uint32_t remaining = 0; /*!< 0 waits forever */
+    if (timeout != 0)
     {
-      case 0:
-      {
-	/*!< If UART_InChar returns true, increment packetCondition */
-	if(UART_InChar(&Packet_Command))
-	{
-	  packetComplete++;
-	}
-	break;
-      }
-      case 1:
-      {
-	/*!< If UART_InChar returns true, increment packetCondition */
-	if(UART_InChar(&Packet_Parameter1))
-	{
-	  packetComplete++;
-	}
-	break;
-      }
-      case 2:
-      {
-	/*!< If UART_InChar returns true, increment packetCondition */
-	if(UART_InChar(&Packet_Parameter2))
-	{
-	  packetComplete++;
-	}
-	break;
-      }
-      case 3:
+      remaining = deadline - OS_TimeGet();
+      if ((int32_t) remaining <= 0)
       {
-	/*!< If UART_InChar returns true, increment packetCondition */
-	if(UART_InChar(&Packet_Parameter3))
-	{
-	  packetComplete++;
-	}
-	break;
-      }
-      case 4:
-      {
-	if(UART_InChar(&Packet_Checksum))
-	{
-	  /*!< If UART_InChar returns true, calculate the byteSum with the previous InChar found */
-	  byteSum = Checksum_Calculation(Packet_Command, Packet_Parameter1, Packet_Parameter2, Packet_Parameter3);
-	  /*!< Check if byteSum is equal to the checksum byte we just fetched */
-	  if(Packet_Checksum == byteSum)
-	  {
-	    /*!< if the checksum and byteSum are equal, break from the switch statement */
-	    packetComplete = 0;
-	    return true;
-	  }
-	  else
-	  {
-	    /*!< Shift the bytes by one to not lose all the data and only getting read of the first byte of invalid data */
-	    Packet_Command = Packet_Parameter1;
-	    Packet_Parameter1 = Packet_Parameter2;
-	    Packet_Parameter2 = Packet_Parameter3;
-	    packetComplete--;
-	    break;
-	  }
-        }
+        return false; /*!< The timeout expired while resynchronising */
       }
     }
+    if (!UART_InWait(PACKET_NB_BYTES, remaining))
+    {
+      return false; /*!< No complete frame before the timeout, the bytes so far stay in the FIFO */
+    }
+    for (uint8_t byteNb = 0; byteNb < PACKET_NB_BYTES; byteNb++)
+    {
+      frame[byteNb] = UART_InPeek(byteNb);
+    }
+    /*!< Check if the checksum of the first four bytes is equal to the fifth byte */
+    if (Checksum_Calculation(frame[0], frame[1], frame[2], frame[3]) == frame[4])
+    {
+      Packet_Command(packet) = frame[0];
+      Packet_Parameter1(packet) = frame[1];
+      Packet_Parameter2(packet) = frame[2];
+      Packet_Parameter3(packet) = frame[3];
+      Packet_Checksum(packet) = frame[4];
+      UART_InDiscard(PACKET_NB_BYTES);
+      return true;
+    }
+    /*!< Only getting rid of the first byte of invalid data, the frame may start at the next one */
+    UART_InDiscard(1);
   }
 }
 
-bool Packet_Put(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+bool Packet_Wait(TPacket* const packet, const uint32_t timeout)
+{
+  if (OS_SemaphoreWait(QueueItemsSemaphore, timeout) != OS_NO_ERROR)
+  {
+    return false; /*!< Nothing was queued before the timeout */
+  }
+  TCritical critical = CRITICAL_ENTER(CRITICAL_PACKET_QUEUE); /*!< Several handler threads can take packets off the queue */
+  *packet = Queue[QueueTail];
+  QueueTail = (QueueTail + 1) % PACKET_QUEUE_SIZE;
+  CRITICAL_EXIT(CRITICAL_PACKET_QUEUE, critical);
+  OS_SemaphoreSignal(QueueSpaceSemaphore);
+  return true;
+}
+
+void PacketReceiverThread(void* pData)
 {
+  TPacket packet;
+
+  for (;;)
+  {
+    if (Packet_Get(&packet, 0))
+    {
+      OS_SemaphoreWait(QueueSpaceSemaphore, 0); /*!< Waits for a handler to free a place */
+      TCritical critical = CRITICAL_ENTER(CRITICAL_PACKET_QUEUE);
+      Queue[QueueHead] = packet;
+      QueueHead = (QueueHead + 1) % PACKET_QUEUE_SIZE;
+      CRITICAL_EXIT(CRITICAL_PACKET_QUEUE, critical);
+      OS_SemaphoreSignal(QueueItemsSemaphore);
+    }
+  }
+}
+
+bool Packet_Register(const uint8_t command, const TPacketHandler handler)
+{
+  if ((command >= PACKET_NB_COMMANDS) || (Handlers[command] != 0))
+  {
+    return false; /*!< A command can only have one handler */
+  }
+  Handlers[command] = handler;
+  return true;
+}
+
+bool Packet_Handle(const TPacket* const packet)
+{
+  uint8_t command = Packet_Command(packet) & ~PACKET_ACK_MASK;
+  TPacketHandler handler = Handlers[command];
+  bool actionSuccess = false;  /*!<  Acknowledge is false as long as the package isn't acknowledge or if it's not required */
+  uint32_t time = 0;
+
+  if (handler)
+  {
+    uint32_t start = Profile_Now();
+    actionSuccess = handler(packet);
+    time = Profile_Now() - start;
+  }
+
+  OS_DisableInterrupts(); /*!< Several handler threads can update the statistics */
+  TPacketStats* stats = &Stats[command];
+  stats->invocations++;
+  if (!actionSuccess)
+    stats->failures++;
+  if (time > stats->maxTime)
+    stats->maxTime = time;
+  stats->totalTime += time;
+  OS_EnableInterrupts();
+
+  if (Packet_Command(packet) & PACKET_ACK_MASK) /*!< if ACK bit is set, need to send back ACK packet if done successfully and NAK packet with bit7 cleared */
+  {
+    uint8_t response = Packet_Command(packet); /*!< The response is built apart, the packet received is left as it is */
+    if (!actionSuccess)
+    {
+      response &= ~PACKET_ACK_MASK; /*!< NAK */
+    }
+    Packet_Put(response, Packet_Parameter1(packet), Packet_Parameter2(packet), Packet_Parameter3(packet));
+  }
+  return actionSuccess;
+}
+
+bool Packet_GetStats(const uint8_t command, TPacketStats* const stats)
+{
+  if (command >= PACKET_NB_COMMANDS)
+  {
+    return false;
+  }
   OS_DisableInterrupts();
-  uint8_t byteSum;
-
-  UART_OutChar(command);
-  UART_OutChar(parameter1);
-  UART_OutChar(parameter2);
-  UART_OutChar(parameter3);
-  byteSum = Checksum_Calculation(command, parameter1, parameter2, parameter3);
-  UART_OutChar(byteSum);
+  *stats = Stats[command];
   OS_EnableInterrupts();
   return true;
 }
 
+bool Packet_Put(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  const uint8_t bytes[PACKET_NB_BYTES] = { command, parameter1, parameter2, parameter3,
+                                           Checksum_Calculation(command, parameter1, parameter2, parameter3) };
+
+  return UART_Out(bytes, PACKET_NB_BYTES); /*!< The 5 bytes go in the transmit FIFO in one critical section, so packets from different threads never interleave */
+}
+
 uint8_t Checksum_Calculation(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
 {
   uint8_t checksum = command^parameter1^parameter2^parameter3;
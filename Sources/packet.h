@@ -17,6 +17,13 @@
 /*!< Packet structure */
 #define PACKET_NB_BYTES 5
 
+/*!< Number of decoded packets waiting to be handled */
+#define PACKET_QUEUE_SIZE 8
+
+/*!< Packet Acknowledgment mask, referring to bit 7 of the command, the other 7 bits are the command itself */
+#define PACKET_ACK_MASK 0x80
+#define PACKET_NB_COMMANDS PACKET_ACK_MASK
+
 #pragma pack(push)
 #pragma pack(1)
 #pragma pack(pop)
@@ -50,15 +57,25 @@ typedef union
   } packetStruct;
 } TPacket;
 
-extern TPacket Packet;
+/*!< Fields of a packet, given a pointer to it */
+#define Packet_Command(packet)     ((packet)->packetStruct.command)
+#define Packet_Parameter1(packet)  ((packet)->packetStruct.parameters.separate.parameter1)
+#define Packet_Parameter2(packet)  ((packet)->packetStruct.parameters.separate.parameter2)
+#define Packet_Parameter3(packet)  ((packet)->packetStruct.parameters.separate.parameter3)
+#define Packet_Parameter12(packet) ((packet)->packetStruct.parameters.combined12.parameter12)
+#define Packet_Parameter23(packet) ((packet)->packetStruct.parameters.combined23.parameter23)
+#define Packet_Checksum(packet)    ((packet)->packetStruct.checksum)
 
-#define Packet_Command     Packet.packetStruct.command
-#define Packet_Parameter1  Packet.packetStruct.parameters.separate.parameter1
-#define Packet_Parameter2  Packet.packetStruct.parameters.separate.parameter2
-#define Packet_Parameter3  Packet.packetStruct.parameters.separate.parameter3
-#define Packet_Parameter12 Packet.packetStruct.parameters.combined12.parameter12
-#define Packet_Parameter23 Packet.packetStruct.parameters.combined23.parameter23
-#define Packet_Checksum    Packet.packetStruct.checksum
+/*!< Handler of a command, returns TRUE if the command has been handled successfully */
+typedef bool (*TPacketHandler)(const TPacket* const packet);
+
+typedef struct
+{
+  uint32_t invocations; /*!< Number of packets received with the command */
+  uint32_t failures;    /*!< Number of packets the handler returned FALSE for, or with no handler registered */
+  uint32_t maxTime;     /*!< Longest time the handler took, in the unit of Profile_Now */
+  uint64_t totalTime;   /*!< Sum of all the times the handler took, for the average */
+} TPacketStats;
 
 /*!<All macro for packets and commands are found in Tower Serial Communication Protocol.pdf */
 
@@ -125,8 +142,57 @@ extern TPacket Packet;
 
 #define DOR_GET_FAULT 4
 
+#define DOR_GET_PROFILE 5 /*!< Parameter2 = stage of the sample processing (TProfileStage) */
+#define DOR_PROFILE_MIN 0
+#define DOR_PROFILE_AVG 1
+#define DOR_PROFILE_MAX 2
+
+#define DOR_GET_CRITICAL 6 /*!< Parameter2 = call site of the critical section (TCriticalSite) */
+#define DOR_CRITICAL_MAX 8 /*!< Statistic after the CRITICAL_NB_BINS histogram bins */
+
+#define DOR_GET_TRIP_REPORT 7 /*!< Parameter2 = IDMT characteristic */
+#define DOR_TRIP_REPORT_ACTUAL 8 /*!< Statistics after the TRIPREPORT_NB_BINS histogram bins */
+#define DOR_TRIP_REPORT_EXPECTED 9
+
+#define DOR_GET_OVERRUNS 8
+#define DOR_OVERRUN_SKIPPED 3 /*!< Statistics after the OVERRUN_NB_STAGES stages */
+#define DOR_OVERRUN_DROPPED 4
+
+#define DOR_DEGRADE 9 /*!< Parameter3 = degradation policy (TDegradePolicy) when setting */
+#define DOR_DEGRADE_GET 1
+#define DOR_DEGRADE_SET 2
+
+#define DOR_GET_COMMAND_STATS 10 /*!< Parameter2 = command, without the acknowledgement bit */
+#define DOR_COMMAND_STATS_INVOCATIONS 0
+#define DOR_COMMAND_STATS_FAILURES 1
+#define DOR_COMMAND_STATS_AVG 2
+#define DOR_COMMAND_STATS_MAX 3
+
+#define DOR_TELEMETRY 11 /*!< Parameter3 = cycles between two telemetry frames when setting, 0 to stop */
+#define DOR_TELEMETRY_GET 1
+#define DOR_TELEMETRY_SET 2
+#define DOR_TELEMETRY_SECONDS_LO 0 /*!< RTC seconds when the frame was sent, low 16 bits */
+#define DOR_TELEMETRY_SECONDS_HI 1 /*!< RTC seconds when the frame was sent, high 16 bits */
+#define DOR_TELEMETRY_SEQUENCE 2 /*!< Sequence number of the first sample of the cycle, low 16 bits */
+#define DOR_TELEMETRY_FREQUENCY 3 /*!< Frequency in hundredths of Hz, 0 if there is no estimate */
+#define DOR_TELEMETRY_CURRENT 4 /*!< Current RMS in hundredths of A, one field per channel from here */
+
 #define DOR_COMMAND_CURRENT 0x71
 
+#define DOR_COMMAND_PROFILE 0x72 /*!< Parameter1 = statistic << 4 | stage, Parameter2-3 = time in CPU cycles */
+
+#define DOR_COMMAND_CRITICAL 0x73 /*!< Parameter1 = bin or DOR_CRITICAL_MAX << 4 | call site, Parameter2-3 = count or time in CPU cycles */
+
+#define DOR_COMMAND_TRIP_REPORT 0x74 /*!< Parameter1 = bin or trip time << 4 | characteristic, Parameter2-3 = count or time in ms */
+
+#define DOR_COMMAND_OVERRUN 0x75 /*!< Parameter1 = stage or statistic, Parameter2-3 = number of frames */
+
+#define DOR_COMMAND_STATS 0x76 /*!< Parameter1 = statistic, Parameter2-3 = count or time in CPU cycles */
+
+#define DOR_COMMAND_TELEMETRY 0x77 /*!< Parameter1 = frame number, Parameter2 = highest trip accumulator in 1/256 of the trip time, Parameter3 = channels over pickup */
+
+#define DOR_COMMAND_TELEMETRY_DATA 0x78 /*!< Parameter1 = frame number, low 4 bits << 4 | field, Parameter2-3 = value */
+
 
 /************************************************************************************************************
  * ************************************** PC TO TOWER COMMANDS **********************************************
@@ -153,11 +219,58 @@ extern TPacket Packet;
  */
 bool Packet_Init(const uint32_t baudRate, const uint32_t moduleClk);
 
-/*! @brief Attempts to get a packet from the received data.
+/*! @brief Waits for a packet to be received.
+ *
+ *  The calling thread sleeps on the receive FIFO between bytes instead of polling it.
+ *  @param packet A pointer to the packet to decode the received bytes into.
+ *  @param timeout The number of OS clock ticks to wait for a whole packet, 0 to wait forever. The time spent
+ *                 skipping invalid bytes counts towards it.
+ *  @return bool - TRUE if a valid packet was received, FALSE if the timeout expired first.
+ *  @note A packet cut by the timeout stays in the receive FIFO, and is completed by the next call.
+ */
+bool Packet_Get(TPacket* const packet, const uint32_t timeout);
+
+/*! @brief Waits for a decoded packet to be taken off the packet queue.
+ *
+ *  Any number of handler threads can wait on the queue, each packet goes to one of them.
+ *  @param packet A pointer to the packet to copy the decoded packet into.
+ *  @param timeout The number of OS clock ticks to wait for, 0 to wait forever.
+ *  @return bool - TRUE if a packet was taken off the queue, FALSE if the timeout expired first.
+ *  @note Assumes that Packet_Init was called.
+ */
+bool Packet_Wait(TPacket* const packet, const uint32_t timeout);
+
+/*! @brief The packet receiver thread, decoding the received bytes and queuing the packets.
+ *
+ *  @param pData - not used.
+ *  @note Waits for room in the queue when it is full, the bytes received meanwhile stay in the receive FIFO.
+ */
+void PacketReceiverThread(void* pData);
+
+/*! @brief Registers the handler of a command, so Packet_Handle dispatches the packets of the command to it.
+ *
+ *  @param command The command handled, without the acknowledgement bit.
+ *  @param handler The handler of the command.
+ *  @return bool - TRUE if the handler was registered, FALSE if the command is out of range or already has a handler.
+ *  @note Each module registers its own commands when it is initialized, before or after Packet_Init.
+ */
+bool Packet_Register(const uint8_t command, const TPacketHandler handler);
+
+/*! @brief Dispatches a packet to the handler of its command, and acknowledges it if asked to.
+ *
+ *  The time the handler takes is added to the statistics of the command.
+ *  @param packet A pointer to the packet to handle, it is never modified.
+ *  @return bool - TRUE if the command was handled successfully.
+ */
+bool Packet_Handle(const TPacket* const packet);
+
+/*! @brief Gets the statistics of a command.
  *
- *  @return bool - TRUE if a valid packet was received.
+ *  @param command The command, without the acknowledgement bit.
+ *  @param stats A copy of the statistics of the command.
+ *  @return bool - TRUE if the command is in range.
  */
-bool Packet_Get(void);
+bool Packet_GetStats(const uint8_t command, TPacketStats* const stats);
 
 /*! @brief Builds a packet and places it in the transmit FIFO buffer.
  *
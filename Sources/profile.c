@@ -0,0 +1,131 @@
+/*! @file
+ *
+ *  @brief Routines to measure how long each stage of the sample processing takes.
+ *
+ *  This contains the functions for operating the profiler.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup profile_module profile module documentation
+**  @{
+*/
+
+#ifndef __arm__
+#define _POSIX_C_SOURCE 199309L /*!< clock_gettime when built on a PC */
+#include <time.h>
+#endif
+
+#include "profile.h"
+#include "OS.h"
+#ifdef __arm__
+#include "MK70F12.h"
+#endif
+
+#define DEMCR_TRCENA_MASK       (1 << 24) /*!< Enables the DWT and ITM units (ARMv7-M ARM C1.6.5) */
+#define DWT_CTRL_CYCCNTENA_MASK (1 << 0) /*!< Enables the cycle counter (ARMv7-M ARM C1.8.7) */
+
+static TProfileStats Stats[PROFILE_NB_STAGES]; /*!< Statistics of each stage */
+static TCriticalStats CriticalStats[CRITICAL_NB_SITES]; /*!< Statistics of each critical section call site */
+
+
+bool Profile_Init(void)
+{
+#ifdef __arm__
+  DEMCR |= DEMCR_TRCENA_MASK; /*!< The DWT is off until trace is enabled */
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= DWT_CTRL_CYCCNTENA_MASK; /*!< Start counting CPU cycles */
+#endif
+  Profile_Reset();
+  return true;
+}
+
+
+uint32_t Profile_Now(void)
+{
+#ifdef __arm__
+  return DWT_CYCCNT;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t) (now.tv_sec * 1000000000ull + now.tv_nsec); /*!< Wraps like CYCCNT, differences are still right */
+#endif
+}
+
+
+void Profile_Record(const TProfileStage stage, const uint32_t time)
+{
+  uint32_t primask = Critical_Lock(); // The profiler is also called from critical sections and the initialisation
+  TProfileStats* stats = &Stats[stage];
+  if ((stats->count == 0) || (time < stats->min))
+    stats->min = time;
+  if (time > stats->max)
+    stats->max = time;
+  stats->total += time;
+  stats->count++;
+  Critical_Unlock(primask);
+}
+
+
+bool Profile_Get(const TProfileStage stage, uint32_t* const min, uint32_t* const avg, uint32_t* const max)
+{
+  if ((stage >= PROFILE_NB_STAGES) || (Stats[stage].count == 0))
+    return false;
+  uint32_t primask = Critical_Lock();
+  *min = Stats[stage].min;
+  *avg = (uint32_t) (Stats[stage].total / Stats[stage].count);
+  *max = Stats[stage].max;
+  Critical_Unlock(primask);
+  return true;
+}
+
+
+void Profile_RecordCritical(const TCriticalSite site, const uint32_t time)
+{
+  TCriticalStats* stats = &CriticalStats[site];
+  int8_t bin = (31 - __builtin_clz(time | 1)) - (CRITICAL_BIN_SHIFT - 1); // Bin 1 is [2^CRITICAL_BIN_SHIFT, 2^(CRITICAL_BIN_SHIFT+1))
+  if (bin < 0)
+    bin = 0;
+  else if (bin >= CRITICAL_NB_BINS)
+    bin = CRITICAL_NB_BINS - 1;
+  stats->histogram[bin]++;
+  if (time > stats->max)
+    stats->max = time;
+}
+
+
+bool Profile_GetCritical(const TCriticalSite site, TCriticalStats* const stats)
+{
+  if (site >= CRITICAL_NB_SITES)
+    return false;
+  uint32_t primask = Critical_Lock();
+  *stats = CriticalStats[site];
+  Critical_Unlock(primask);
+  return true;
+}
+
+
+void Profile_Reset(void)
+{
+  uint32_t primask = Critical_Lock();
+  for (uint8_t stage = 0; stage < PROFILE_NB_STAGES; stage++)
+  {
+    Stats[stage].min = 0;
+    Stats[stage].max = 0;
+    Stats[stage].count = 0;
+    Stats[stage].total = 0;
+  }
+  for (uint8_t site = 0; site < CRITICAL_NB_SITES; site++)
+  {
+    CriticalStats[site].max = 0;
+    for (uint8_t bin = 0; bin < CRITICAL_NB_BINS; bin++)
+      CriticalStats[site].histogram[bin] = 0;
+  }
+  Critical_Unlock(primask);
+}
+
+/*!
+* @}
+*/
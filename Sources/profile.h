@@ -0,0 +1,214 @@
+/*! @file
+ *
+ *  @brief Routines to measure how long each stage of the sample processing takes.
+ *
+ *  Stages are wrapped in PROFILE_BEGIN/PROFILE_END, which compile to nothing unless PROFILE_ENABLED is defined.
+ *  Critical sections are wrapped in CRITICAL_ENTER/CRITICAL_EXIT, which save and restore PRIMASK so they nest, and
+ *  only do that unless CRITICAL_MONITOR_ENABLED is defined, in which case the time the interrupts stay masked is
+ *  recorded per call site.
+ *  On the K70 the time is read from the DWT cycle counter, elsewhere from clock_gettime in ns.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+// new types
+#include "types.h"
+#include "OS.h"
+
+// Define PROFILE_ENABLED to measure the stages of the sample processing
+//#define PROFILE_ENABLED
+
+// Define CRITICAL_MONITOR_ENABLED to measure how long each critical section masks the interrupts
+//#define CRITICAL_MONITOR_ENABLED
+
+typedef enum
+{
+  PROFILE_ANALOG_GET,      /*!< Reading the ADC */
+  PROFILE_SLIDING_VOLTAGE, /*!< Adding the sample to the window */
+  PROFILE_REAL_RMS,        /*!< Voltage RMS of the window */
+  PROFILE_CURRENT_RMS,     /*!< Voltage RMS to current RMS */
+  PROFILE_TRIP,            /*!< IDMT trip element and trip decision */
+  PROFILE_ANALOG_PUT,      /*!< Writing the DAC outputs */
+  PROFILE_SAMPLE_INTERVAL, /*!< Time between two samples, max - min is the tick to sample jitter */
+  PROFILE_NB_STAGES
+} TProfileStage;
+
+typedef struct
+{
+  uint32_t min;   /*!< Shortest time of the stage */
+  uint32_t max;   /*!< Longest time of the stage */
+  uint32_t count; /*!< Number of times the stage has been measured */
+  uint64_t total; /*!< Sum of all the times, for the average */
+} TProfileStats;
+
+typedef enum
+{
+  CRITICAL_FIFO_PUT,     /*!< Writing bytes to a FIFO, the 5 bytes of a packet at once */
+  CRITICAL_FIFO_GET,     /*!< Reading a byte from a FIFO */
+  CRITICAL_ANALOG_GET,   /*!< Sampling all the channels */
+  CRITICAL_ANALOG_PUT,   /*!< Writing a DAC output from the sampler thread */
+  CRITICAL_PACKET_QUEUE, /*!< Queuing or taking a decoded packet */
+  CRITICAL_NB_SITES
+} TCriticalSite;
+
+#define CRITICAL_NB_BINS   8 /*!< Bins of the histogram, each one twice as wide as the previous one */
+#define CRITICAL_BIN_SHIFT 6 /*!< The first bin is under 2^CRITICAL_BIN_SHIFT, the last one is 2^(CRITICAL_BIN_SHIFT+CRITICAL_NB_BINS-2) and over */
+
+typedef struct
+{
+  uint32_t max;                          /*!< Longest time the interrupts were masked */
+  uint32_t histogram[CRITICAL_NB_BINS];  /*!< Number of critical sections in each bin */
+} TCriticalStats;
+
+typedef struct
+{
+  uint32_t primask; /*!< PRIMASK before the section, put back when it ends */
+#ifdef CRITICAL_MONITOR_ENABLED
+  uint32_t start;   /*!< Time the interrupts were masked */
+#endif
+} TCritical;
+
+#ifdef __arm__
+#include "Cpu.h"
+#define PROFILE_TICKS_PER_US    (CPU_CORE_CLK_HZ / 1000000) /*!< Profile_Now counts CPU cycles */
+#else
+#define PROFILE_TICKS_PER_US    1000 /*!< Profile_Now counts ns */
+#endif
+
+#if defined(PROFILE_ENABLED) || defined(CRITICAL_MONITOR_ENABLED)
+#ifdef __arm__
+#include "MK70F12.h"
+#define PROFILE_NOW()           DWT_CYCCNT
+#else
+#define PROFILE_NOW()           Profile_Now()
+#endif
+#endif
+
+#ifdef PROFILE_ENABLED
+#define PROFILE_BEGIN(stage)    const uint32_t profileStart_##stage = PROFILE_NOW()
+#define PROFILE_END(stage)      Profile_Record(stage, PROFILE_NOW() - profileStart_##stage)
+#else
+#define PROFILE_BEGIN(stage)
+#define PROFILE_END(stage)
+#endif
+
+// TCritical critical = CRITICAL_ENTER(site); ... CRITICAL_EXIT(site, critical);
+#define CRITICAL_ENTER(site)            Critical_Enter()
+#define CRITICAL_EXIT(site, critical)   Critical_Exit(site, critical)
+
+/*! @brief Sets up the time source and clears the statistics.
+ *
+ *  @return bool - TRUE if the profiler was successfully initialized.
+ */
+bool Profile_Init(void);
+
+/*! @brief Gets the current time of the profiler.
+ *
+ *  @return uint32_t - current time, in CPU cycles on the K70 and in ns elsewhere.
+ */
+uint32_t Profile_Now(void);
+
+/*! @brief Adds one measurement to the statistics of a stage.
+ *
+ *  @param stage - stage that has been measured.
+ *  @param time - time the stage took, in the unit of Profile_Now.
+ */
+void Profile_Record(const TProfileStage stage, const uint32_t time);
+
+/*! @brief Gets the min, average and max time of a stage.
+ *
+ *  @param stage - stage to get the statistics of.
+ *  @param min - shortest time of the stage.
+ *  @param avg - average time of the stage.
+ *  @param max - longest time of the stage.
+ *  @return bool - TRUE if the stage exists and has been measured at least once.
+ */
+bool Profile_Get(const TProfileStage stage, uint32_t* const min, uint32_t* const avg, uint32_t* const max);
+
+/*! @brief Adds one critical section to the statistics of its call site.
+ *
+ *  @param site - call site of the critical section.
+ *  @param time - time the interrupts were masked, in the unit of Profile_Now.
+ *  @note Called with the interrupts still masked.
+ */
+void Profile_RecordCritical(const TCriticalSite site, const uint32_t time);
+
+/*! @brief Gets the longest time and the histogram of the critical sections of a call site.
+ *
+ *  @param site - call site to get the statistics of.
+ *  @param stats - copy of the statistics of the call site.
+ *  @return bool - TRUE if the call site exists.
+ */
+bool Profile_GetCritical(const TCriticalSite site, TCriticalStats* const stats);
+
+/*! @brief Clears the statistics of all the stages and critical sections.
+ *
+ */
+void Profile_Reset(void);
+
+/*! @brief Masks the interrupts, saving whether they were already masked.
+ *
+ *  OS_DisableInterrupts does not nest: OS_EnableInterrupts would unmask the interrupts in the middle of an outer
+ *  critical section, or of an ISR.
+ *  @return uint32_t - PRIMASK before masking, to give back to Critical_Unlock.
+ */
+static inline uint32_t Critical_Lock(void)
+{
+#ifdef __arm__
+  uint32_t primask;
+  __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+  return primask;
+#else
+  OS_DisableInterrupts();
+  return 0;
+#endif
+}
+
+/*! @brief Puts the interrupts back the way they were before Critical_Lock.
+ *
+ *  @param primask - value returned by Critical_Lock.
+ */
+static inline void Critical_Unlock(const uint32_t primask)
+{
+#ifdef __arm__
+  __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+#else
+  (void)primask;
+  OS_EnableInterrupts();
+#endif
+}
+
+/*! @brief Starts a critical section, used through CRITICAL_ENTER.
+ *
+ *  @return TCritical - state to give back to Critical_Exit.
+ */
+static inline TCritical Critical_Enter(void)
+{
+  TCritical critical;
+  critical.primask = Critical_Lock();
+#ifdef CRITICAL_MONITOR_ENABLED
+  critical.start = PROFILE_NOW();
+#endif
+  return critical;
+}
+
+/*! @brief Ends a critical section, used through CRITICAL_EXIT.
+ *
+ *  @param site - call site of the critical section.
+ *  @param critical - value returned by Critical_Enter.
+ */
+static inline void Critical_Exit(const TCriticalSite site, const TCritical critical)
+{
+#ifdef CRITICAL_MONITOR_ENABLED
+  Profile_RecordCritical(site, PROFILE_NOW() - critical.start);
+#else
+  (void)site;
+#endif
+  Critical_Unlock(critical.primask);
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*! @file
+ *
+ *  @brief Routines of the protection engine, run on all the channels for every sample.
+ *
+ *  This contains the functions for operating the protection engine.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup protection_module protection module documentation
+**  @{
+*/
+
+#include "protection.h"
+#include "profile.h"
+
+TProtection Protection;
+
+
+void Protection_Reset(void)
+{
+  for (uint8_t channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+  {
+    Protection.sample[channelNb] = 0;
+    Reset_Channel(&Protection.window[channelNb]);
+    Protection.voltageRMS[channelNb] = 0;
+    Protection.currentRMS[channelNb] = 0;
+    Reset_Trip(&Protection.tripElement[channelNb]);
+  }
+}
+
+
+bool Protection_Process(const int16_t samples[NB_ANALOG_CHANNELS], bool* const tripped)
+{
+  uint8_t channelNb;
+  bool pickedUp = false;
+
+  for (channelNb = 0; channelNb < NB_ANALOG_CHANNELS; channelNb++)
+    Protection.sample[channelNb] = samples[channelNb];
+#ifdef PROTECTION_RESIDUAL
+  int32_t residual = 0;
+  for (channelNb = 0; channelNb < NB_ANALOG_CHANNELS; channelNb++)
+    residual += samples[channelNb];
+  if (residual > INT16_MAX) // Saturating like the ADC would
+    residual = INT16_MAX;
+  else if (residual < INT16_MIN)
+    residual = INT16_MIN;
+  Protection.sample[PROTECTION_RESIDUAL_CHANNEL] = (int16_t) residual;
+#endif
+
+  PROFILE_BEGIN(PROFILE_SLIDING_VOLTAGE);
+  for (channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+    Sliding_voltage(Protection.sample[channelNb], &Protection.window[channelNb]); // Adding the new sample value to the window
+  PROFILE_END(PROFILE_SLIDING_VOLTAGE);
+
+  PROFILE_BEGIN(PROFILE_REAL_RMS);
+  if (Current_Measurement == MEASUREMENT_FUNDAMENTAL)
+    for (channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+      Protection.voltageRMS[channelNb] = Fundamental_RMS(&Protection.window[channelNb]); // Fundamental only, ignoring harmonics and DC offset
+  else
+    for (channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+      Protection.voltageRMS[channelNb] = Real_RMS(&Protection.window[channelNb]); // Voltage RMS of the last NB_SAMPLES samples
+  PROFILE_END(PROFILE_REAL_RMS);
+
+  PROFILE_BEGIN(PROFILE_CURRENT_RMS);
+  for (channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+    Protection.currentRMS[channelNb] = Current_RMS(Protection.voltageRMS[channelNb]);
+  PROFILE_END(PROFILE_CURRENT_RMS);
+
+  PROFILE_BEGIN(PROFILE_TRIP);
+  *tripped = false;
+  for (channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+  {
+    if (Update_Trip(&Protection.tripElement[channelNb], Protection.currentRMS[channelNb])) // Integrating the sample towards the trip time
+      *tripped = true;
+    if (Protection.currentRMS[channelNb] > CURRENT_PICKUP)
+      pickedUp = true;
+  }
+  PROFILE_END(PROFILE_TRIP);
+
+  return pickedUp;
+}
+
+/*!
+* @}
+*/
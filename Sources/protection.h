@@ -0,0 +1,54 @@
+/*! @file
+ *
+ *  @brief Routines of the protection engine, run on all the channels for every sample.
+ *
+ *  The state of the channels is kept as a structure of arrays, so each stage of the processing
+ *  is one loop over contiguous arrays instead of a pass over scattered per-channel structures.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef PROTECTION_H
+#define PROTECTION_H
+
+// new types
+#include "types.h"
+#include "calculation.h"
+#include "acquisition.h"
+
+// Define PROTECTION_RESIDUAL to also protect the residual current, the sum of the phase currents
+//#define PROTECTION_RESIDUAL
+
+#ifdef PROTECTION_RESIDUAL
+#define PROTECTION_RESIDUAL_CHANNEL NB_ANALOG_CHANNELS       /*!< The residual comes after the phases */
+#define NB_PROTECTION_CHANNELS      (NB_ANALOG_CHANNELS + 1)
+#else
+#define NB_PROTECTION_CHANNELS      NB_ANALOG_CHANNELS
+#endif
+
+typedef struct
+{
+  int16_t sample[NB_PROTECTION_CHANNELS];           /*!< Newest sample of each channel, in ADC counts */
+  TChannelData window[NB_PROTECTION_CHANNELS];      /*!< Sliding window of each channel */
+  TVoltage voltageRMS[NB_PROTECTION_CHANNELS];      /*!< Voltage RMS of each window */
+  TCurrent currentRMS[NB_PROTECTION_CHANNELS];      /*!< Current RMS of each channel */
+  TTripElement tripElement[NB_PROTECTION_CHANNELS]; /*!< IDMT trip element of each channel */
+} TProtection;
+
+extern TProtection Protection; // Keeping track of the state of every channel
+
+/*! @brief Clears the windows, the measurements and the trip elements of all the channels.
+ *
+ */
+void Protection_Reset(void);
+
+/*! @brief Runs the protection on one sample of every analog channel.
+ *
+ *  @param samples - newest sample of each analog channel, in ADC counts.
+ *  @param tripped - TRUE if the trip time of any channel has been reached.
+ *  @return bool - TRUE if the current of any channel is over the pickup current.
+ */
+bool Protection_Process(const int16_t samples[NB_ANALOG_CHANNELS], bool* const tripped);
+
+#endif
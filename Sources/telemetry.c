@@ -0,0 +1,93 @@
+/*! @file
+ *
+ *  @brief Routines to push the measurements to the PC at a fixed rate, instead of waiting for it to poll them.
+ *
+ *  This contains the functions for operating the telemetry.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup telemetry_module telemetry module documentation
+**  @{
+*/
+
+#include "telemetry.h"
+#include "packet.h"
+#include "protection.h"
+#include "metering.h"
+#include "RTC.h"
+
+#define FRAME_NB_MASK 0x0F /*!< Bits of the frame number each data packet carries */
+
+static volatile uint8_t Period; /*!< Cycles between two frames, 0 if not subscribed - only written by the packet handler */
+static uint8_t FrameNb;         /*!< Number of the frame being sent - only the metering thread touches it */
+
+/*! @brief Sends one field of the current telemetry frame, saturated to 16 bits.
+ *
+ *  @param field - field of the frame.
+ *  @param value - value of the field.
+ */
+static void PutField(const uint8_t field, const uint32_t value)
+{
+  uint16union_t saturated;
+  saturated.l = (value > 0xFFFF) ? 0xFFFF : value;
+  // Other threads can queue packets in the middle of a frame, the frame number lets the PC tell whose field it is
+  Packet_Put(DOR_COMMAND_TELEMETRY_DATA, ((FrameNb & FRAME_NB_MASK) << 4) | field, saturated.s.Lo, saturated.s.Hi);
+}
+
+
+void Telemetry_Subscribe(const uint8_t period)
+{
+  Period = period; // The metering thread restarts its countdown when it sees the change
+}
+
+
+uint8_t Telemetry_Period(void)
+{
+  return Period;
+}
+
+
+void Telemetry_Cycle(const uint32_t sequence)
+{
+  static uint8_t lastPeriod; // Period the countdown was started for
+  static uint8_t countdown;  // Cycles left until the next frame - only the metering thread touches these
+  uint8_t period = Period;
+  if (period != lastPeriod)
+  {
+    lastPeriod = period;
+    countdown = 0; // The first frame goes out on this cycle
+  }
+  if ((period == 0) || (countdown-- > 0))
+    return;
+  countdown = period - 1;
+
+  uint32_t highest = 0; // Accumulator of the element closest to tripping
+  uint8_t pickedUp = 0; // One bit per channel over pickup
+  for (uint8_t channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+  {
+    uint32_t accumulator = Protection.tripElement[channelNb].accumulator;
+    if (accumulator > highest)
+      highest = accumulator;
+    if (Protection.currentRMS[channelNb] > CURRENT_PICKUP)
+      pickedUp |= (1 << channelNb);
+  }
+
+  FrameNb++;
+  Packet_Put(DOR_COMMAND_TELEMETRY, FrameNb,
+             (highest >= TRIP_ONE) ? 0xFF : (uint8_t) (highest >> 23), // Fraction of the trip time elapsed, in 1/256
+             pickedUp);
+  uint32_t seconds = RTC_Seconds();
+  PutField(DOR_TELEMETRY_SECONDS_LO, seconds & 0xFFFF);
+  PutField(DOR_TELEMETRY_SECONDS_HI, seconds >> 16);
+  PutField(DOR_TELEMETRY_SEQUENCE, sequence & 0xFFFF); // Orders the frames within a second
+  PutField(DOR_TELEMETRY_FREQUENCY, (uint32_t) (Metering.frequency * 100));
+  for (uint8_t channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+    PutField(DOR_TELEMETRY_CURRENT + channelNb, CURRENT_TO_CENTIAMPS(Protection.currentRMS[channelNb]));
+}
+
+/*!
+* @}
+*/
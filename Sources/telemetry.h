@@ -0,0 +1,41 @@
+/*! @file
+ *
+ *  @brief Routines to push the measurements to the PC at a fixed rate, instead of waiting for it to poll them.
+ *
+ *  Once subscribed, a telemetry frame is sent every period, in cycles of the waveform. A frame is one
+ *  DOR_COMMAND_TELEMETRY packet with the frame number and the state of the trip elements, followed by one
+ *  DOR_COMMAND_TELEMETRY_DATA packet per 16-bit field: the RTC seconds and the sample sequence number the
+ *  frame was taken at, the frequency, then the current RMS of each channel.
+ *  Each data packet carries the low bits of the frame number, so the PC can drop fields that do not belong
+ *  to the frame it is assembling when other packets were queued in between.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// new types
+#include "types.h"
+
+/*! @brief Starts or stops sending telemetry frames.
+ *
+ *  @param period - number of cycles between two frames, 0 to stop.
+ */
+void Telemetry_Subscribe(const uint8_t period);
+
+/*! @brief Gets the number of cycles between two telemetry frames.
+ *
+ *  @return uint8_t - the period of the frames, 0 if they are not sent.
+ */
+uint8_t Telemetry_Period(void);
+
+/*! @brief Counts one cycle, and sends a telemetry frame once the period is over.
+ *
+ *  @param sequence - sequence number of the first sample of the cycle.
+ *  @note Called by the metering thread once per cycle.
+ */
+void Telemetry_Cycle(const uint32_t sequence);
+
+#endif
@@ -0,0 +1,141 @@
+/*! @file
+ *
+ *  @brief Routines to assert the trip output at the deadline of the IDMT curve.
+ *
+ *  This contains the functions for operating the trip timer.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup trip_module trip module documentation
+**  @{
+*/
+
+#include "trip.h"
+#include "Cpu.h"
+#include "FTM.h"
+#include "OS.h"
+#include "profile.h"
+#include "protection.h"
+
+#define FTM_CLK_HZ CPU_MCGFF_CLK_HZ_CONFIG_0 /*!< FTM0 runs from the fixed frequency clock */
+
+static void (*AssertTrip)(void*);  /*!< User function asserting the trip output */
+static bool Asserted;              /*!< TRUE once the trip of the fault has been asserted */
+static bool Armed;                 /*!< TRUE while the output compare is waiting for the deadline */
+static uint8_t ArmedChannel;       /*!< Channel the deadline has been calculated for */
+static uint32_t ArmedIncrement;    /*!< Increment the deadline has been calculated for, changes with the current and the characteristic */
+
+static void TripTimerCallback(void* pData);
+
+static TFTMChannel TripTimer =
+{
+  .channelNb = TRIP_FTM_CHANNEL,
+  .delayCount = 0,
+  .timerFunction = TIMER_FUNCTION_OUTPUT_COMPARE,
+  .ioType.outputAction = TIMER_OUTPUT_DISCONNECT,
+  .callbackFunction = TripTimerCallback,
+  .callbackArguments = NULL
+};
+
+
+/*! @brief Asserts the trip output once per fault, from the FTM ISR or from the sampler thread.
+ *
+ */
+static void Trip_Assert(void)
+{
+  OS_DisableInterrupts(); // Both the FTM ISR and the sampler thread may get here first
+  bool first = !Asserted;
+  Asserted = true;
+  OS_EnableInterrupts();
+  if (first && AssertTrip)
+    (*AssertTrip)(NULL);
+}
+
+
+static void TripTimerCallback(void* pData)
+{
+  Armed = false;
+  Trip_Assert();
+}
+
+
+bool Trip_Init(void (*assertTrip)(void*))
+{
+  AssertTrip = assertTrip;
+  Asserted = false;
+  Armed = false;
+  return FTM_Init() && FTM_Set(&TripTimer);
+}
+
+
+void Trip_Update(const uint32_t timestamp, const bool tripped)
+{
+  if (Asserted)
+    return;
+  if (tripped)
+  {
+    // The deadline was too far to arm, or already passed when the sample was processed
+    (void) FTM_StopTimer(&TripTimer);
+    Armed = false;
+    Trip_Assert();
+    return;
+  }
+
+  // The element that needs the least time to reach its trip at its current
+  uint8_t earliest = NB_PROTECTION_CHANNELS;
+  uint64_t earliestTime = 0;
+  for (uint8_t channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+  {
+    const TTripElement* const element = &Protection.tripElement[channelNb];
+    if ((Protection.currentRMS[channelNb] <= CURRENT_PICKUP) || !element->increment)
+      continue;
+    uint64_t time = ((uint64_t) (TRIP_ONE - element->accumulator) * Get_SamplePeriod()) / element->increment; // in ns
+    if ((earliest == NB_PROTECTION_CHANNELS) || (time < earliestTime))
+    {
+      earliest = channelNb;
+      earliestTime = time;
+    }
+  }
+
+  if ((earliest == NB_PROTECTION_CHANNELS) || (earliestTime / 1000 > TRIP_HORIZON))
+  {
+    // Under pickup, or too far for the FTM: the accumulators keep timing and the deadline is armed once it is close enough
+    if (Armed)
+      (void) FTM_StopTimer(&TripTimer);
+    Armed = false;
+    return;
+  }
+  if (Armed && (earliest == ArmedChannel) && (Protection.tripElement[earliest].increment == ArmedIncrement))
+    return; // Same increment, so the same deadline
+
+  // The deadline counts from when the sample was taken, not from now
+  uint32_t elapsed = (Profile_Now() - timestamp) / PROFILE_TICKS_PER_US;
+  uint32_t remaining = (uint32_t) (earliestTime / 1000);
+  remaining = (remaining > elapsed) ? (remaining - elapsed) : 0;
+  uint32_t delayCount = (uint32_t) (((uint64_t) remaining * FTM_CLK_HZ) / 1000000);
+
+  OS_DisableInterrupts(); // The FTM ISR must not see a half programmed compare
+  if (delayCount == 0)
+    delayCount = 1; // Already due, match on the next count
+  TripTimer.delayCount = (uint16_t) delayCount;
+  (void) FTM_StartTimer(&TripTimer);
+  Armed = true;
+  ArmedChannel = earliest;
+  ArmedIncrement = Protection.tripElement[earliest].increment;
+  OS_EnableInterrupts();
+}
+
+
+void Trip_Reset(void)
+{
+  (void) FTM_StopTimer(&TripTimer);
+  Armed = false;
+  Asserted = false;
+}
+
+/*!
+* @}
+*/
@@ -0,0 +1,42 @@
+/*! @file
+ *
+ *  @brief Routines to assert the trip output at the deadline of the IDMT curve.
+ *
+ *  Once the trip is close enough to fit in the FTM counter, the remaining time of the trip element closest to its
+ *  trip is turned into an absolute deadline from the time its sample was taken, and an FTM0 output compare is armed
+ *  for it. The output is then asserted from the FTM ISR at the timer resolution instead of on a sample tick.
+ *  The deadline is only reprogrammed when the current of that element changes.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef TRIP_H
+#define TRIP_H
+
+// new types
+#include "types.h"
+
+#define TRIP_FTM_CHANNEL  0       /*!< FTM0 channel timing the trip */
+#define TRIP_HORIZON      1000000 /*!< The output compare is armed when the trip is closer than this, in us, the FTM wraps after 2.6s */
+
+/*! @brief Sets up the FTM channel timing the trip.
+ *
+ *  @param assertTrip - function asserting the trip output, called from the FTM ISR or from Trip_Update.
+ *  @return bool - TRUE if the trip timer was successfully initialized.
+ */
+bool Trip_Init(void (*assertTrip)(void*));
+
+/*! @brief Reprograms the trip deadline after a sample has been processed by the protection.
+ *
+ *  @param timestamp - time the sample was taken, from Profile_Now.
+ *  @param tripped - TRUE if a trip element has reached its trip on this sample, which asserts the trip if the timer has not.
+ */
+void Trip_Update(const uint32_t timestamp, const bool tripped);
+
+/*! @brief Cancels the deadline and allows the trip to be asserted again, after the breaker has been reset.
+ *
+ */
+void Trip_Reset(void);
+
+#endif
@@ -0,0 +1,88 @@
+/*! @file
+ *
+ *  @brief Routines to measure how accurately the relay trips against its IDMT curve.
+ *
+ *  This contains the functions for operating the trip report.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+/*!
+**  @addtogroup tripreport_module tripreport module documentation
+**  @{
+*/
+
+#include "tripreport.h"
+#include "OS.h"
+#include "profile.h"
+
+#define NB_CHARACTERISTICS (EXTREMELY_INVERSE + 1)
+
+static TTripReport Reports[NB_CHARACTERISTICS]; /*!< Report of each characteristic */
+static uint32_t FaultSamples;                   /*!< Samples since the fault started, 0 when there is no fault */
+static uint32_t LastTimestamp;                  /*!< Time the last sample was taken */
+static bool Reported;                           /*!< TRUE once the trip of the current fault has been recorded */
+
+
+void TripReport_Update(const bool pickedUp, const uint32_t timestamp)
+{
+  LastTimestamp = timestamp;
+  if (pickedUp)
+  {
+    FaultSamples++;
+  }
+  else
+  {
+    FaultSamples = 0;
+    Reported = false;
+  }
+}
+
+
+void TripReport_Trip(const TCurrent current)
+{
+  if (Reported || (FaultSamples == 0) || (Current_Charac >= NB_CHARACTERISTICS))
+    return;
+  Reported = true;
+
+  // Each sample over pickup stands for the period before it, like in Update_Trip, plus the time since the last one
+  // The samples and the goal are counted at the actual sample period, which follows the frequency
+  uint32_t period = Get_SamplePeriod(); // in ns
+  uint32_t binWidth = period / 1000;
+  uint32_t latency = (Profile_Now() - LastTimestamp) / PROFILE_TICKS_PER_US;
+  uint32_t actual = (uint32_t) (((uint64_t) FaultSamples * period) / 1000) + latency;
+  uint32_t expected = (uint32_t) (((uint64_t) Calculate_TripGoal(current) * period) / 1000);
+  int8_t bin;
+  if (actual < expected)
+    bin = (expected - actual > binWidth) ? 0 : 1; // An early trip never falls in the bin of a zero error
+  else
+  {
+    uint32_t late = (actual - expected) / binWidth; // in whole sample periods
+    bin = TRIPREPORT_BIN_ZERO + ((late == 0) ? 0 : (32 - __builtin_clz(late))); // Log2 bins, like the critical section histogram
+    if (bin >= TRIPREPORT_NB_BINS)
+      bin = TRIPREPORT_NB_BINS - 1;
+  }
+
+  TTripReport* const report = &Reports[Current_Charac];
+  OS_DisableInterrupts();
+  report->histogram[bin]++;
+  report->actual = actual;
+  report->expected = expected;
+  OS_EnableInterrupts();
+}
+
+
+bool TripReport_Get(const TCharacteristic charac, TTripReport* const report)
+{
+  if (charac >= NB_CHARACTERISTICS)
+    return false;
+  OS_DisableInterrupts();
+  *report = Reports[charac];
+  OS_EnableInterrupts();
+  return true;
+}
+
+/*!
+* @}
+*/
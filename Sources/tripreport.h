@@ -0,0 +1,55 @@
+/*! @file
+ *
+ *  @brief Routines to measure how accurately the relay trips against its IDMT curve.
+ *
+ *  The fault starts one sample period before the first sample a current is over pickup, as the trip elements
+ *  count it, and ends when the trip output is asserted.
+ *  The time in between is compared with the trip time of the curve for the fault current, and the error is
+ *  kept in a histogram per characteristic.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef TRIPREPORT_H
+#define TRIPREPORT_H
+
+// new types
+#include "types.h"
+#include "calculation.h"
+
+// Error histogram, in sample periods: bin 0 is more than one early, bin 1 is up to one early, bin 2 is [0, 1) late,
+// then each bin is twice as wide as the previous one, [1, 2), [2, 4), [4, 8), [8, 16), and the last bin is 16 and over
+#define TRIPREPORT_NB_BINS      8 /*!< Bins of the error histogram */
+#define TRIPREPORT_BIN_ZERO     2 /*!< Bin of an error under one sample period late, the early bins are before it */
+
+typedef struct
+{
+  uint32_t histogram[TRIPREPORT_NB_BINS]; /*!< Number of trips per error bin, from early to late */
+  uint32_t actual;                        /*!< Fault to trip output time of the last trip, in us */
+  uint32_t expected;                      /*!< Trip time of the curve for the last trip, in us */
+} TTripReport;
+
+/*! @brief Tracks the start of the fault, once per sample.
+ *
+ *  @param pickedUp - TRUE if a current is over pickup on this sample.
+ *  @param timestamp - time the sample was taken, from Profile_Now.
+ */
+void TripReport_Update(const bool pickedUp, const uint32_t timestamp);
+
+/*! @brief Records the trip of the current fault, the first time its output is asserted.
+ *
+ *  @param current - highest current RMS of the channels, which the trip time of the curve is taken for.
+ *  @note Called right after the trip output has been asserted, from a thread or an ISR.
+ */
+void TripReport_Trip(const TCurrent current);
+
+/*! @brief Gets the report of a characteristic.
+ *
+ *  @param charac - IDMT characteristic to get the report of.
+ *  @param report - copy of the report.
+ *  @return bool - TRUE if the characteristic exists.
+ */
+bool TripReport_Get(const TCharacteristic charac, TTripReport* const report);
+
+#endif
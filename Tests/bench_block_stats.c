@@ -0,0 +1,97 @@
+/*! @file
+ *
+ *  @brief Checks Block_Stats against a reference and measures its throughput on the host.
+ *
+ *  The host runs the portable loop of Block_Stats: the dual MAC loop is only built for the Cortex-M4.
+ *  The Makefile builds this benchmark twice, with the compiler's vectorisation off and on, so both the scalar
+ *  and the SIMD code the compiler generates for the portable loop are measured.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#include <stdlib.h>
+#include "check.h"
+#include "calculation.h"
+
+#define BLOCK_SIZE  (4 * NB_SAMPLES) /*!< Samples per block, 4 cycles like the metering blocks */
+#define NB_BLOCKS   1024             /*!< Blocks cycled through, so the samples do not all stay in the L1 cache */
+#define NB_PASSES   2000             /*!< Passes over all the blocks when timing */
+
+static int16_t Samples[NB_BLOCKS][BLOCK_SIZE];
+
+/*! @brief Calculates the statistics of a block one at a time, as the reference.
+ *
+ *  @param samples - block of samples.
+ *  @param nbSamples - number of samples in the block.
+ *  @param stats - statistics of the block.
+ */
+static void Reference_Stats(const int16_t samples[], const uint16_t nbSamples, TBlockStats* const stats)
+{
+  stats->sumSqr = 0;
+  stats->sum = 0;
+  stats->min = INT16_MAX;
+  stats->max = INT16_MIN;
+  for (uint16_t i = 0; i < nbSamples; i++)
+    stats->sumSqr += (int64_t) samples[i] * samples[i];
+  for (uint16_t i = 0; i < nbSamples; i++)
+    stats->sum += samples[i];
+  for (uint16_t i = 0; i < nbSamples; i++)
+    if (samples[i] < stats->min)
+      stats->min = samples[i];
+  for (uint16_t i = 0; i < nbSamples; i++)
+    if (samples[i] > stats->max)
+      stats->max = samples[i];
+}
+
+/*! @brief Times a statistics function over all the blocks.
+ *
+ *  @param name - name of the function, for the report.
+ *  @param function - function to time.
+ */
+static void Time(const char* const name, void (*function)(const int16_t[], const uint16_t, TBlockStats* const))
+{
+  TBlockStats stats;
+  volatile uint64_t sink = 0; // Keeps the results, so the calls are not optimised away
+  double start = Check_Now();
+  for (int pass = 0; pass < NB_PASSES; pass++)
+    for (int blockNb = 0; blockNb < NB_BLOCKS; blockNb++)
+    {
+      function(Samples[blockNb], BLOCK_SIZE, &stats);
+      sink += stats.sumSqr + stats.sum + stats.min + stats.max;
+    }
+  double seconds = (Check_Now() - start) * 1e-9;
+  printf("%-14s %8.1f Msamples/s\n", name, (double) NB_PASSES * NB_BLOCKS * BLOCK_SIZE / seconds / 1e6);
+  (void) sink;
+}
+
+
+int main(void)
+{
+  srand(1);
+  for (int blockNb = 0; blockNb < NB_BLOCKS; blockNb++)
+    for (int i = 0; i < BLOCK_SIZE; i++)
+      Samples[blockNb][i] = (int16_t) ((rand() & 0xFFFF) - 0x8000);
+  Samples[0][0] = INT16_MIN; // Full scale in both directions, the squares and the sum must not overflow
+  Samples[0][1] = INT16_MAX;
+  for (int i = 0; i < BLOCK_SIZE; i++)
+    Samples[1][i] = INT16_MIN;
+
+  // Every block, and odd lengths, which leave one sample to the portable loop on the M4
+  for (int blockNb = 0; blockNb < NB_BLOCKS; blockNb++)
+  {
+    uint16_t nbSamples = (blockNb & 1) ? BLOCK_SIZE - 1 : BLOCK_SIZE;
+    TBlockStats stats, expected;
+    Block_Stats(Samples[blockNb], nbSamples, &stats);
+    Reference_Stats(Samples[blockNb], nbSamples, &expected);
+    CHECK((stats.sumSqr == expected.sumSqr) && (stats.sum == expected.sum) && (stats.min == expected.min) && (stats.max == expected.max),
+          "Block %d: sumSqr %llu sum %d min %d max %d, expected %llu %d %d %d", blockNb,
+          (unsigned long long) stats.sumSqr, stats.sum, stats.min, stats.max,
+          (unsigned long long) expected.sumSqr, expected.sum, expected.min, expected.max);
+  }
+
+  Time("Block_Stats", Block_Stats);
+  Time("Reference", Reference_Stats);
+  printf("%s: %d failure(s)\n", Check_Failures ? "FAILED" : "PASSED", Check_Failures);
+  return Check_Failures ? 1 : 0;
+}
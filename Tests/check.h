@@ -0,0 +1,45 @@
+/*! @file
+ *
+ *  @brief Checks and timing shared by the host tests.
+ *
+ *  Each test is one program: CHECK counts the failures, and the program returns non-zero if there were any.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+#include <time.h>
+
+static int Check_Failures; /*!< Number of checks that failed so far */
+
+/*! @brief Counts a failure and prints the message if the condition is false.
+ *
+ */
+#define CHECK(condition, ...) \
+  do \
+  { \
+    if (!(condition)) \
+    { \
+      Check_Failures++; \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+    } \
+  } while (0)
+
+/*! @brief Gets a monotonic time, to measure how long a call takes.
+ *
+ *  @return double - time in ns.
+ */
+static inline double Check_Now(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+#endif
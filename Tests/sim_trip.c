@@ -0,0 +1,87 @@
+/*! @file
+ *
+ *  @brief Host simulation of the fault to trip time, through the protection engine and the trip report.
+ *
+ *  For each characteristic, step faults at several currents are fed to Protection_Process one sample at a time,
+ *  after a few cycles of load current. The trip is reported as soon as a trip element reaches its goal, like the
+ *  sampler thread does when the deadline has already passed. The trip report of each fault is printed, and the
+ *  trips are checked to be no earlier than the curve and at most one cycle later, the time the window takes to
+ *  fill with the fault.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#include <math.h>
+#include "check.h"
+#include "calculation.h"
+#include "protection.h"
+#include "profile.h"
+#include "tripreport.h"
+
+#define VOLTS_PER_AMP 0.350 /*!< 350mV RMS = 1 A RMS (project notes) */
+#define LOAD_CURRENT  0.5   /*!< Current before the fault, in A */
+#define LOAD_CYCLES   4     /*!< Cycles of load current before the fault */
+
+static const char* const CHARAC_NAMES[] = { "inverse", "very inverse", "extremely inverse" };
+static const char* const BIN_NAMES[TRIPREPORT_NB_BINS] = { "<-1", "-1..0", "0..1", "1..2", "2..4", "4..8", "8..16", ">=16" };
+
+/*! @brief Feeds one sample of a sine on channel 0 and no current on the others.
+ *
+ *  @param amps - RMS of the sine, in A.
+ *  @param sampleNb - sample number since the start of the simulation.
+ *  @param tripped - TRUE if a trip element has reached its goal.
+ *  @return bool - TRUE if a current is over pickup.
+ */
+static bool Feed(const double amps, const uint32_t sampleNb, bool* const tripped)
+{
+  int16_t samples[NB_ANALOG_CHANNELS] = { 0 };
+  samples[0] = (int16_t) lround(amps * M_SQRT2 * sin(2 * M_PI * sampleNb / NB_SAMPLES) * VOLTS_PER_AMP * ADC_RATE);
+  bool pickedUp = Protection_Process(samples, tripped);
+  TripReport_Update(pickedUp, Profile_Now());
+  return pickedUp;
+}
+
+
+int main(void)
+{
+  static const double faults[] = { 1.5, 2.0, 5.0, 10.0, 20.0 };
+  Profile_Init();
+  for (TCharacteristic charac = INVERSE; charac <= EXTREMELY_INVERSE; charac++)
+  {
+    Current_Charac = charac;
+    printf("Characteristic %d, %s:\n", charac, CHARAC_NAMES[charac]);
+    for (unsigned i = 0; i < sizeof(faults) / sizeof(faults[0]); i++)
+    {
+      bool tripped = false;
+      uint32_t sampleNb = 0;
+      Protection_Reset();
+      for (; sampleNb < LOAD_CYCLES * NB_SAMPLES; sampleNb++)
+        Feed(LOAD_CURRENT, sampleNb, &tripped);
+      // Far past the longest trip time of these faults, in case it never trips
+      for (uint32_t faultSamples = 0; !tripped && (faultSamples < 1000000); faultSamples++, sampleNb++)
+        Feed(faults[i], sampleNb, &tripped);
+      CHECK(tripped, "No trip at %.1f A", faults[i]);
+      TripReport_Trip(Protection.currentRMS[0]);
+
+      TTripReport report;
+      TripReport_Get(charac, &report);
+      double error = ((double) report.actual - report.expected) / (SAMPLE_PERIOD / 1000); // in samples
+      printf("  %5.1f A: trip after %9.2f ms, curve %9.2f ms, %+5.2f samples\n",
+             faults[i], report.actual / 1000.0, report.expected / 1000.0, error);
+      CHECK(error > -1, "Trip at %.1f A is %.2f samples early", faults[i], -error);
+      CHECK(error <= NB_SAMPLES, "Trip at %.1f A is %.2f samples late", faults[i], error);
+    }
+
+    TTripReport report;
+    TripReport_Get(charac, &report);
+    printf("  Error histogram:");
+    for (uint8_t bin = 0; bin < TRIPREPORT_NB_BINS; bin++)
+      printf(" %s %u,", BIN_NAMES[bin], report.histogram[bin]);
+    printf(" in samples\n");
+    CHECK(report.histogram[0] + report.histogram[1] + report.histogram[TRIPREPORT_NB_BINS - 1] == 0,
+          "Characteristic %d: trips early or a cycle late in the histogram", charac);
+  }
+  printf("%s: %d failure(s)\n", Check_Failures ? "FAILED" : "PASSED", Check_Failures);
+  return Check_Failures ? 1 : 0;
+}
@@ -0,0 +1,44 @@
+/*! @file
+ *
+ *  @brief Host stand-in for the RTOS, so the modules can be built and tested on a PC.
+ *
+ *  Only the parts of Library/OS.h the tested modules use are provided. Semaphores are POSIX semaphores,
+ *  and masking the interrupts does nothing, since there are none on the host.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef OS_H
+#define OS_H
+
+// Standard types
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+typedef enum
+{
+  OS_NO_ERROR,
+  OS_TIMEOUT,
+  OS_SEMAPHORE_OVERFLOW
+} OS_ERROR;
+
+typedef sem_t OS_ECB;
+
+OS_ECB* OS_SemaphoreCreate(const uint32_t value);
+
+OS_ERROR OS_SemaphoreSignal(OS_ECB* const pEvent);
+
+/*! @brief Waits on a semaphore.
+ *
+ *  @param pEvent - semaphore to wait on.
+ *  @param timeout - 0 to wait forever, otherwise the wait only polls the semaphore once.
+ *  @return OS_ERROR - OS_NO_ERROR if the semaphore was taken, OS_TIMEOUT otherwise.
+ */
+OS_ERROR OS_SemaphoreWait(OS_ECB* const pEvent, const uint32_t timeout);
+
+#define OS_DisableInterrupts()
+#define OS_EnableInterrupts()
+
+#endif
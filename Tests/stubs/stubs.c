@@ -0,0 +1,84 @@
+/*! @file
+ *
+ *  @brief Host stand-ins for the RTOS, the PIT, the RTC, the analog library and the packet layer.
+ *
+ *  This contains the functions the tested modules call into the rest of the firmware.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#include <stdlib.h>
+#include "stubs.h"
+#include "OS.h"
+#include "PIT.h"
+#include "analog.h"
+#include "RTC.h"
+#include "packet.h"
+
+int16_t (*Stub_AnalogInput)(const uint8_t channelNb);
+uint32_t Stub_PITPeriod;
+uint32_t Stub_RTCSeconds;
+TStubPacket Stub_Packets[STUBS_NB_PACKETS];
+uint32_t Stub_NbPackets;
+uint32_t Stub_NbSignals;
+
+
+OS_ECB* OS_SemaphoreCreate(const uint32_t value)
+{
+  OS_ECB* semaphore = malloc(sizeof(OS_ECB));
+  if (semaphore)
+    sem_init(semaphore, 0, value);
+  return semaphore;
+}
+
+
+OS_ERROR OS_SemaphoreSignal(OS_ECB* const pEvent)
+{
+  __atomic_fetch_add(&Stub_NbSignals, 1, __ATOMIC_RELAXED);
+  return (sem_post(pEvent) == 0) ? OS_NO_ERROR : OS_SEMAPHORE_OVERFLOW;
+}
+
+
+OS_ERROR OS_SemaphoreWait(OS_ECB* const pEvent, const uint32_t timeout)
+{
+  if (timeout == 0)
+  {
+    while (sem_wait(pEvent) != 0); // Only interrupted by a signal
+    return OS_NO_ERROR;
+  }
+  return (sem_trywait(pEvent) == 0) ? OS_NO_ERROR : OS_TIMEOUT;
+}
+
+
+void PIT_Set(const uint32_t period, const bool restart, uint8_t channel)
+{
+  (void) restart;
+  (void) channel;
+  Stub_PITPeriod = period;
+}
+
+
+bool Analog_Get(const uint8_t channelNb, int16_t* const valuePtr)
+{
+  *valuePtr = Stub_AnalogInput ? Stub_AnalogInput(channelNb) : 0;
+  return true;
+}
+
+
+uint32_t RTC_Seconds(void)
+{
+  return Stub_RTCSeconds;
+}
+
+
+bool Packet_Put(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  TStubPacket* const packet = &Stub_Packets[Stub_NbPackets % STUBS_NB_PACKETS];
+  packet->command = command;
+  packet->parameter1 = parameter1;
+  packet->parameter2 = parameter2;
+  packet->parameter3 = parameter3;
+  Stub_NbPackets++;
+  return true;
+}
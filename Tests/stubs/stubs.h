@@ -0,0 +1,36 @@
+/*! @file
+ *
+ *  @brief Host stand-ins for the PIT, the RTC, the analog library and the packet layer.
+ *
+ *  The tests drive the stand-ins through the hooks below: the analog inputs come from a function of the test,
+ *  the RTC reads a variable of the test, and the PIT period, the semaphore signals and the packets sent are
+ *  recorded so the test can check them.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#ifndef STUBS_H
+#define STUBS_H
+
+// new types
+#include "types.h"
+
+#define STUBS_NB_PACKETS 16 /*!< Packets kept by the Packet_Put stand-in, the oldest are overwritten */
+
+typedef struct
+{
+  uint8_t command;
+  uint8_t parameter1;
+  uint8_t parameter2;
+  uint8_t parameter3;
+} TStubPacket;
+
+extern int16_t (*Stub_AnalogInput)(const uint8_t channelNb); /*!< Value Analog_Get returns for a channel, 0 if NULL */
+extern uint32_t Stub_PITPeriod;                              /*!< Last period given to PIT_Set, in ns */
+extern uint32_t Stub_RTCSeconds;                             /*!< Value RTC_Seconds returns */
+extern TStubPacket Stub_Packets[STUBS_NB_PACKETS];           /*!< Packets given to Packet_Put */
+extern uint32_t Stub_NbPackets;                              /*!< Number of packets given to Packet_Put so far */
+extern uint32_t Stub_NbSignals;                              /*!< Number of times any semaphore has been signaled */
+
+#endif
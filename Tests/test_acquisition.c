@@ -0,0 +1,126 @@
+/*! @file
+ *
+ *  @brief Stress test of the acquisition queue with a producer and a consumer pthread on the host.
+ *
+ *  The producer stands in for the PIT ISR and calls Acquisition_Sample, the consumer stands in for the sampler
+ *  thread and drains the queue with Acquisition_Get. Every frame carries samples derived from its sequence
+ *  number, with the number itself in the first two channels, so a frame that is lost, read twice or read half
+ *  written is detected.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include "check.h"
+#include "stubs.h"
+#include "acquisition.h"
+
+#define NB_FRAMES 10000000 /*!< Frames the producer samples */
+
+static volatile bool ProducerDone;  /*!< TRUE once the producer has sampled every frame */
+static uint32_t ProducerSequence;   /*!< Sequence number of the frame being sampled, only used by the producer */
+
+/*! @brief Gives each channel of a frame a value derived from its sequence number.
+ *
+ *  @param sequence - sequence number of the frame.
+ *  @param channelNb - channel of the frame.
+ *  @return int16_t - value of the sample.
+ */
+static int16_t Pattern(const uint32_t sequence, const uint8_t channelNb)
+{
+  if (channelNb == 0)
+    return (int16_t) sequence;
+  if (channelNb == 1)
+    return (int16_t) (sequence >> 16);
+  return (int16_t) (sequence * NB_ANALOG_CHANNELS + channelNb);
+}
+
+/*! @brief Gets the sequence number a frame was sampled with, from its first two channels.
+ *
+ *  @param frame - frame read from the queue.
+ *  @return uint32_t - sequence number of the frame.
+ */
+static uint32_t Sequence(const TSampleFrame* const frame)
+{
+  return (uint16_t) frame->samples[0] | ((uint32_t) (uint16_t) frame->samples[1] << 16);
+}
+
+/*! @brief Analog input of the producer, the pattern of the frame being sampled.
+ *
+ *  @param channelNb - channel being sampled.
+ *  @return int16_t - value of the sample.
+ */
+static int16_t ProducerInput(const uint8_t channelNb)
+{
+  return Pattern(ProducerSequence, channelNb);
+}
+
+
+static void* Producer(void* arg)
+{
+  (void) arg;
+  for (ProducerSequence = 0; ProducerSequence < NB_FRAMES; ProducerSequence++)
+  {
+    Acquisition_Sample();
+    // Once per block, like the sampler thread is woken, except for a burst of blocks now and then to overflow the queue
+    uint32_t blockNb = ProducerSequence / ACQUISITION_BLOCK_SIZE;
+    if ((((ProducerSequence + 1) % ACQUISITION_BLOCK_SIZE) == 0) && ((blockNb % 64) >= 3))
+      sched_yield();
+  }
+  __atomic_store_n(&ProducerDone, true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+
+int main(void)
+{
+  Acquisition_Init();
+  Stub_AnalogInput = ProducerInput;
+
+  pthread_t producer;
+  pthread_create(&producer, NULL, Producer, NULL);
+
+  TSampleFrame frame;
+  uint32_t received = 0, gaps = 0, errors = 0;
+  int64_t lastSequence = -1;
+  for (;;)
+  {
+    bool done = __atomic_load_n(&ProducerDone, __ATOMIC_ACQUIRE); // Read before the queue, so the last frames are not missed
+    if (!Acquisition_Get(&frame))
+    {
+      if (done)
+        break;
+      sched_yield(); // Empty, lets the producer run if they share a core
+      continue;
+    }
+    received++;
+    uint32_t sequence = Sequence(&frame);
+    if ((int64_t) sequence <= lastSequence)
+      errors++; // Read twice, or out of order
+    else
+      gaps += sequence - (uint32_t) (lastSequence + 1); // Frames dropped since the last one
+    if (frame.sequence != sequence)
+      errors++; // Sequence number of another frame
+    for (uint8_t channelNb = 0; channelNb < NB_ANALOG_CHANNELS; channelNb++)
+      if (frame.samples[channelNb] != Pattern(sequence, channelNb))
+        errors++; // Torn frame
+    lastSequence = sequence;
+  }
+  pthread_join(producer, NULL);
+  gaps += NB_FRAMES - (uint32_t) (lastSequence + 1); // Dropped after the last frame read
+
+  uint32_t signals = Stub_NbSignals; // Only the block semaphore is signaled in this test
+
+  printf("%u frames: %u received, %u dropped, %u out of order or torn, %u block signals\n",
+         NB_FRAMES, received, Acquisition_Dropped(), errors, signals);
+  CHECK(errors == 0, "%u frames out of order or torn", errors);
+  CHECK(received + Acquisition_Dropped() == NB_FRAMES, "%u received + %u dropped != %u sampled", received, Acquisition_Dropped(), NB_FRAMES);
+  CHECK(gaps == Acquisition_Dropped(), "%u frames missing from the sequence, %u counted as dropped", gaps, Acquisition_Dropped());
+  CHECK(Acquisition_Ticks() == NB_FRAMES, "%u ticks counted, %u sampled", Acquisition_Ticks(), NB_FRAMES);
+  // One signal per block of ticks, even when the last frame of the block was dropped
+  CHECK(signals == NB_FRAMES / ACQUISITION_BLOCK_SIZE, "%u block signals, expected %u", signals, NB_FRAMES / ACQUISITION_BLOCK_SIZE);
+  printf("%s: %d failure(s)\n", Check_Failures ? "FAILED" : "PASSED", Check_Failures);
+  return Check_Failures ? 1 : 0;
+}
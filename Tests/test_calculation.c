@@ -0,0 +1,229 @@
+/*! @file
+ *
+ *  @brief Golden waveform tests of calculation.c on the host.
+ *
+ *  Synthetic waveforms (pure sines, harmonics and DC offset, a step fault, off-nominal frequencies) are fed to
+ *  the measurement functions, and the RMS, the fundamental, the frequency and the IDMT trip goals are checked
+ *  against the values calculated in double precision. The time of each call is reported, so a change to these
+ *  functions can be measured as well as checked.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#include <math.h>
+#include "check.h"
+#include "stubs.h"
+#include "calculation.h"
+
+#define VOLTS_PER_AMP     0.350 /*!< 350mV RMS = 1 A RMS (project notes) */
+#define RMS_TOLERANCE     0.005 /*!< Relative error allowed on the RMS and the fundamental */
+#define RMS_TOLERANCE_MA  2     /*!< Plus the error allowed from the quantisation, in mA */
+#define FREQUENCY_TOLERANCE 0.01 /*!< Error allowed on the frequency, in Hz */
+#define TIMING_CALLS      1000000 /*!< Calls per function when timing them */
+
+static const double IDMT_K[3] = { 0.14, 13.5, 80.0 };  /*!< IEC 60255 k of each TCharacteristic */
+static const double IDMT_ALPHA[3] = { 0.02, 1.0, 2.0 }; /*!< IEC 60255 alpha of each TCharacteristic */
+
+/*! @brief Converts a current to the ADC counts the relay samples.
+ *
+ *  @param amps - instantaneous current, in A.
+ *  @return int16_t - sample, in ADC counts.
+ */
+static int16_t Counts(const double amps)
+{
+  return (int16_t) lround(amps * VOLTS_PER_AMP * ADC_RATE);
+}
+
+/*! @brief Checks a measured current against its reference.
+ *
+ *  @param name - what is measured, for the message.
+ *  @param current - measured current.
+ *  @param expected - reference, in A.
+ */
+static void CheckCurrent(const char* const name, const TCurrent current, const double expected)
+{
+  double measured = CURRENT_TO_MILLIAMPS(current) / 1000.0;
+  double tolerance = expected * RMS_TOLERANCE + RMS_TOLERANCE_MA / 1000.0;
+  CHECK(fabs(measured - expected) <= tolerance, "%s = %.4f A, expected %.4f A", name, measured, expected);
+}
+
+/*! @brief Feeds one cycle of a waveform made of a fundamental, its harmonics and a DC offset.
+ *
+ *  @param channel - window the samples are added to.
+ *  @param rms - RMS of each harmonic in A, the fundamental first, up to nbHarmonics.
+ *  @param nbHarmonics - number of harmonics.
+ *  @param offset - DC offset, in A.
+ *  @param phase - phase of the fundamental at the first sample, in radians.
+ */
+static void FeedCycle(TChannelData* const channel, const double rms[], const int nbHarmonics, const double offset, const double phase)
+{
+  for (int sampleNb = 0; sampleNb < NB_SAMPLES; sampleNb++)
+  {
+    double angle = phase + 2 * M_PI * sampleNb / NB_SAMPLES;
+    double amps = offset;
+    for (int harmonic = 0; harmonic < nbHarmonics; harmonic++)
+      amps += rms[harmonic] * M_SQRT2 * sin((harmonic + 1) * angle);
+    Sliding_voltage(Counts(amps), channel);
+  }
+}
+
+
+static void TestPureSine(void)
+{
+  static const double currents[] = { 0.5, 1.03, 5.0, 20.0 };
+  TChannelData channel;
+  for (unsigned i = 0; i < sizeof(currents) / sizeof(currents[0]); i++)
+  {
+    Reset_Channel(&channel);
+    FeedCycle(&channel, &currents[i], 1, 0, 0.3);
+    FeedCycle(&channel, &currents[i], 1, 0, 0.3);
+    CheckCurrent("Pure sine RMS", Current_RMS(Real_RMS(&channel)), currents[i]);
+    CheckCurrent("Pure sine fundamental", Current_RMS(Fundamental_RMS(&channel)), currents[i]);
+  }
+}
+
+
+static void TestHarmonics(void)
+{
+  static const double harmonics[5] = { 2.0, 0, 0.6, 0, 0.4 }; // 30% third and 20% fifth harmonic
+  const double offset = 0.1;
+  TChannelData channel;
+  Reset_Channel(&channel);
+  FeedCycle(&channel, harmonics, 5, offset, 1.1);
+  CheckCurrent("Harmonics RMS", Current_RMS(Real_RMS(&channel)), sqrt(2.0*2.0 + 0.6*0.6 + 0.4*0.4 + offset*offset));
+  CheckCurrent("Harmonics fundamental", Current_RMS(Fundamental_RMS(&channel)), 2.0);
+}
+
+
+static void TestStepFault(void)
+{
+  const double load = 0.5, fault = 5.0;
+  TChannelData channel;
+  Reset_Channel(&channel);
+  FeedCycle(&channel, &load, 1, 0, 0);
+  FeedCycle(&channel, &fault, 1, 0, 0);
+  // The window holds exactly one cycle, so the fault is measured in full one cycle after the step
+  CheckCurrent("Step fault RMS", Current_RMS(Real_RMS(&channel)), fault);
+  CheckCurrent("Step fault fundamental", Current_RMS(Fundamental_RMS(&channel)), fault);
+}
+
+
+static void TestTripGoal(void)
+{
+  static const double currents[] = { 1.05, 1.1, 1.5, 2.0, 5.0, 10.0, 20.0, 30.0 };
+  for (TCharacteristic charac = INVERSE; charac <= EXTREMELY_INVERSE; charac++)
+  {
+    Current_Charac = charac;
+    for (unsigned i = 0; i < sizeof(currents) / sizeof(currents[0]); i++)
+    {
+      double time = IDMT_TMS * IDMT_K[charac] / (pow(currents[i], IDMT_ALPHA[charac]) - 1); // Is = 1 A
+      double expected = time / (SAMPLE_PERIOD * 1e-9);
+      uint32_t goal = Calculate_TripGoal(CURRENT_FROM_AMPS(currents[i]));
+      CHECK(fabs(goal - expected) <= 1, "Trip goal of characteristic %d at %.2f A = %u samples, expected %.1f",
+            charac, currents[i], goal, expected);
+    }
+
+    // A constant current trips on the goal sample
+    TTripElement element;
+    Reset_Trip(&element);
+    TCurrent current = CURRENT_FROM_AMPS(5.0);
+    uint32_t goal = Calculate_TripGoal(current);
+    uint32_t samples = 1;
+    while (!Update_Trip(&element, current) && (samples <= goal))
+      samples++;
+    CHECK(samples == goal, "Trip element of characteristic %d tripped after %u samples, goal %u", charac, samples, goal);
+  }
+  Current_Charac = INVERSE;
+}
+
+
+static void TestFrequency(void)
+{
+  static const double frequencies[] = { 50.0, 52.4, 47.6, 50.7 };
+  const double amps = 2.0;
+  TFrequencyTracker tracker = { 0 };
+  TChannelData channel;
+  double phase = 0;
+  Reset_Channel(&channel);
+  Stub_PITPeriod = SAMPLE_PERIOD;
+  for (unsigned i = 0; i < sizeof(frequencies) / sizeof(frequencies[0]); i++)
+  {
+    float estimate = 0;
+    // The sample clock is steered from the estimates, and locks within a few hundred cycles
+    for (uint32_t sampleNb = 0; sampleNb < 600 * NB_SAMPLES; sampleNb++)
+    {
+      int16_t sample = Counts(amps * M_SQRT2 * sin(phase));
+      Sliding_voltage(sample, &channel);
+      if (Update_Frequency(&tracker, sample))
+      {
+        estimate = Calculate_Frequency(&tracker);
+        if (estimate != 0)
+          Adjust_SampleClock(&tracker);
+      }
+      phase = fmod(phase + 2 * M_PI * frequencies[i] * Stub_PITPeriod * 1e-9, 2 * M_PI);
+    }
+    double samplesPerCycle = 1e9 / (frequencies[i] * Stub_PITPeriod);
+    CHECK(fabs(estimate - frequencies[i]) <= FREQUENCY_TOLERANCE, "Frequency = %.4f Hz, expected %.4f Hz", estimate, frequencies[i]);
+    CHECK(fabs(samplesPerCycle - NB_SAMPLES) <= 0.01, "%.4f samples per cycle at %.2f Hz", samplesPerCycle, frequencies[i]);
+    CHECK(Get_SamplePeriod() == Stub_PITPeriod, "Sample period %u ns, PIT set to %u ns", Get_SamplePeriod(), Stub_PITPeriod);
+    CheckCurrent("Off-nominal fundamental", Current_RMS(Fundamental_RMS(&channel)), amps);
+  }
+}
+
+
+static void TimeCalls(void)
+{
+  static int16_t samples[NB_SAMPLES];
+  for (int sampleNb = 0; sampleNb < NB_SAMPLES; sampleNb++)
+    samples[sampleNb] = Counts(5.0 * M_SQRT2 * sin(2 * M_PI * sampleNb / NB_SAMPLES));
+  TChannelData channel;
+  TFrequencyTracker tracker = { 0 };
+  volatile uint32_t sink = 0; // Keeps the results, so the calls are not optimised away
+  double start;
+  Reset_Channel(&channel);
+
+  start = Check_Now();
+  for (uint32_t i = 0; i < TIMING_CALLS; i++)
+    Sliding_voltage(samples[i & SAMPLES_MASK], &channel);
+  printf("Sliding_voltage    %6.1f ns/call\n", (Check_Now() - start) / TIMING_CALLS);
+
+  start = Check_Now();
+  for (uint32_t i = 0; i < TIMING_CALLS; i++)
+    sink += (uint32_t) Real_RMS(&channel);
+  printf("Real_RMS           %6.1f ns/call\n", (Check_Now() - start) / TIMING_CALLS);
+
+  start = Check_Now();
+  for (uint32_t i = 0; i < TIMING_CALLS; i++)
+    sink += (uint32_t) Fundamental_RMS(&channel);
+  printf("Fundamental_RMS    %6.1f ns/call\n", (Check_Now() - start) / TIMING_CALLS);
+
+  start = Check_Now();
+  for (uint32_t i = 0; i < TIMING_CALLS; i++)
+    sink += (uint32_t) Current_RMS((TVoltage) (i & 0xFFFF));
+  printf("Current_RMS        %6.1f ns/call\n", (Check_Now() - start) / TIMING_CALLS);
+
+  start = Check_Now();
+  for (uint32_t i = 0; i < TIMING_CALLS; i++)
+    sink += Calculate_TripGoal(CURRENT_FROM_AMPS(1.1) + (TCurrent) (i & 0x3FFF));
+  printf("Calculate_TripGoal %6.1f ns/call\n", (Check_Now() - start) / TIMING_CALLS);
+
+  start = Check_Now();
+  for (uint32_t i = 0; i < TIMING_CALLS; i++)
+    sink += Update_Frequency(&tracker, samples[i & SAMPLES_MASK]);
+  printf("Update_Frequency   %6.1f ns/call\n", (Check_Now() - start) / TIMING_CALLS);
+  (void) sink;
+}
+
+
+int main(void)
+{
+  TestPureSine();
+  TestHarmonics();
+  TestStepFault();
+  TestTripGoal();
+  TestFrequency();
+  TimeCalls();
+  printf("%s: %d failure(s)\n", Check_Failures ? "FAILED" : "PASSED", Check_Failures);
+  return Check_Failures ? 1 : 0;
+}
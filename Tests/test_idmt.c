@@ -0,0 +1,77 @@
+/*! @file
+ *
+ *  @brief Compares the IDMT curve engine with the closed form of the IEC 60255 curves on the host.
+ *
+ *  Calculate_TripGoal is evaluated at every mA over the range of the table, for each characteristic, and
+ *  compared with t = TMS*k/((I/Is)^alpha - 1) in double precision. The clamping at both ends of the table and
+ *  the monotonicity of the curves are checked too.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#include <math.h>
+#include "check.h"
+#include "calculation.h"
+
+#define GOAL_TOLERANCE          1      /*!< Error allowed on the trip goal from rounding it down, in samples */
+#define GOAL_TOLERANCE_RELATIVE 0.0005 /*!< Plus the interpolation error of the table, 0.05% */
+
+static const double IDMT_K[3] = { 0.14, 13.5, 80.0 };  /*!< IEC 60255 k of each TCharacteristic */
+static const double IDMT_ALPHA[3] = { 0.02, 1.0, 2.0 }; /*!< IEC 60255 alpha of each TCharacteristic */
+
+/*! @brief Calculates the trip goal from the closed form of the curve.
+ *
+ *  @param charac - IDMT characteristic.
+ *  @param milliamps - current, in mA.
+ *  @return double - trip time, in samples.
+ */
+static double Expected_Goal(const TCharacteristic charac, const uint32_t milliamps)
+{
+  double ratio = (double) milliamps / IDMT_SETTING;
+  double time = IDMT_TMS * IDMT_K[charac] / (pow(ratio, IDMT_ALPHA[charac]) - 1);
+  return time / (SAMPLE_PERIOD * 1e-9);
+}
+
+
+int main(void)
+{
+  for (TCharacteristic charac = INVERSE; charac <= EXTREMELY_INVERSE; charac++)
+  {
+    Current_Charac = charac;
+    double maxError = 0, maxRelative = 0, maxExcess = 0; // Excess is the error beyond the tolerance
+    uint32_t maxErrorAt = 0;
+    uint32_t lastGoal = UINT32_MAX;
+    for (uint32_t milliamps = IDMT_SETTING + IDMT_DELTA_MIN; milliamps < IDMT_SETTING + IDMT_DELTA_MAX; milliamps++)
+    {
+      TCurrent current = CURRENT_FROM_AMPS(milliamps / 1000.0);
+      uint32_t goal = Calculate_TripGoal(current);
+      double expected = Expected_Goal(charac, CURRENT_TO_MILLIAMPS(current)); // The current as the engine sees it, after rounding
+      double error = fabs(goal - expected);
+      if (error > maxError)
+      {
+        maxError = error;
+        maxErrorAt = milliamps;
+      }
+      if (error / expected > maxRelative)
+        maxRelative = error / expected;
+      if (error - (GOAL_TOLERANCE + expected * GOAL_TOLERANCE_RELATIVE) > maxExcess)
+        maxExcess = error - (GOAL_TOLERANCE + expected * GOAL_TOLERANCE_RELATIVE);
+      CHECK(goal <= lastGoal, "Characteristic %d: goal goes up from %u to %u samples at %u mA", charac, lastGoal, goal, milliamps);
+      lastGoal = goal;
+    }
+    printf("Characteristic %d: largest error %.2f samples at %u mA, largest relative error %.4f%%\n",
+           charac, maxError, maxErrorAt, maxRelative * 100);
+    CHECK(maxExcess == 0, "Characteristic %d: error beyond the tolerance by up to %.2f samples", charac, maxExcess);
+
+    // Outside the table the goal is clamped to its ends, instead of reading past them
+    uint32_t lowest = Calculate_TripGoal(CURRENT_FROM_AMPS((IDMT_SETTING + IDMT_DELTA_MIN) / 1000.0));
+    uint32_t highest = Calculate_TripGoal(CURRENT_FROM_AMPS((IDMT_SETTING + IDMT_DELTA_MAX - 1) / 1000.0));
+    CHECK(Calculate_TripGoal(CURRENT_FROM_AMPS(1.0)) == lowest, "Characteristic %d: not clamped at Is", charac);
+    CHECK(Calculate_TripGoal(CURRENT_FROM_AMPS(0)) == lowest, "Characteristic %d: not clamped at 0 A", charac);
+    CHECK(Calculate_TripGoal(CURRENT_FROM_AMPS(40.0)) == highest, "Characteristic %d: not clamped at 40 A", charac);
+    CHECK(Calculate_TripGoal(CURRENT_FROM_AMPS(1000.0)) == highest, "Characteristic %d: not clamped at 1000 A", charac);
+  }
+  printf("%s: %d failure(s)\n", Check_Failures ? "FAILED" : "PASSED", Check_Failures);
+  return Check_Failures ? 1 : 0;
+}
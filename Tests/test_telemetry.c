@@ -0,0 +1,110 @@
+/*! @file
+ *
+ *  @brief Decodes the telemetry frames on the host.
+ *
+ *  Telemetry_Cycle stands in for the metering thread, with the packets recorded by the Packet_Put stand-in.
+ *  Each frame is decoded like the PC would and checked against the measurements it was built from, and every
+ *  data packet is checked to carry the number of the frame it belongs to.
+ *
+ *  @author Lucien Tran & Angus Ryan
+ *  @date 2026-10-17
+ */
+
+#include "check.h"
+#include "stubs.h"
+#include "packet.h"
+#include "protection.h"
+#include "metering.h"
+#include "telemetry.h"
+
+#define PACKET_SIZE      5 /*!< Bytes of a packet on the UART, with the checksum */
+#define NB_FIELDS        (DOR_TELEMETRY_CURRENT + NB_PROTECTION_CHANNELS) /*!< The time, the frequency and the currents */
+#define NB_FRAME_PACKETS (1 + NB_FIELDS) /*!< The header, then one packet per field */
+
+TProtection Protection;
+TMetering Metering;
+
+/*! @brief Sends one frame and checks it decodes back to the measurements.
+ *
+ *  @param frameNb - number the header of the frame should carry.
+ *  @param seconds - RTC seconds when the frame is sent.
+ *  @param sequence - sequence number of the first sample of the cycle.
+ *  @param frequency - frequency the frame should carry, in hundredths of Hz, or 0 if there is no estimate.
+ */
+static void CheckFrame(const uint8_t frameNb, const uint32_t seconds, const uint32_t sequence, const uint32_t frequency)
+{
+  Stub_NbPackets = 0;
+  Stub_RTCSeconds = seconds;
+  Telemetry_Subscribe(1);
+  Telemetry_Cycle(sequence);
+  CHECK(Stub_NbPackets == NB_FRAME_PACKETS, "%u packets per frame, expected %u", Stub_NbPackets, NB_FRAME_PACKETS);
+  if (Stub_NbPackets != NB_FRAME_PACKETS)
+    return;
+
+  const TStubPacket* const header = &Stub_Packets[0];
+  CHECK(header->command == DOR_COMMAND_TELEMETRY, "Header command %02x", header->command);
+  CHECK(header->parameter1 == frameNb, "Frame number %u, expected %u", header->parameter1, frameNb);
+  CHECK(header->parameter2 == 0x40, "Trip state %u, expected 64/256", header->parameter2);
+  CHECK(header->parameter3 == 0x07, "Pickup mask %02x, expected 07", header->parameter3);
+
+  uint32_t fields[NB_FIELDS];
+  for (uint8_t fieldNb = 0; fieldNb < NB_FIELDS; fieldNb++)
+  {
+    const TStubPacket* const packet = &Stub_Packets[1 + fieldNb];
+    CHECK(packet->command == DOR_COMMAND_TELEMETRY_DATA, "Data command %02x", packet->command);
+    CHECK((packet->parameter1 >> 4) == (frameNb & 0x0F), "Field %u carries frame %u, expected %u", fieldNb, packet->parameter1 >> 4, frameNb & 0x0F);
+    CHECK((packet->parameter1 & 0x0F) == fieldNb, "Field %u sent as field %u", fieldNb, packet->parameter1 & 0x0F);
+    fields[fieldNb] = packet->parameter2 | (packet->parameter3 << 8);
+  }
+
+  uint32_t decodedSeconds = fields[DOR_TELEMETRY_SECONDS_LO] | (fields[DOR_TELEMETRY_SECONDS_HI] << 16);
+  CHECK(decodedSeconds == seconds, "RTC seconds %u, expected %u", decodedSeconds, seconds);
+  CHECK(fields[DOR_TELEMETRY_SEQUENCE] == (sequence & 0xFFFF), "Sequence %u, expected %u", fields[DOR_TELEMETRY_SEQUENCE], sequence & 0xFFFF);
+  CHECK(fields[DOR_TELEMETRY_FREQUENCY] == frequency, "Frequency %u cHz, expected %u", fields[DOR_TELEMETRY_FREQUENCY], frequency);
+  for (uint8_t channelNb = 0; channelNb < NB_PROTECTION_CHANNELS; channelNb++)
+  {
+    uint32_t expected = CURRENT_TO_CENTIAMPS(Protection.currentRMS[channelNb]);
+    if (expected > 0xFFFF)
+      expected = 0xFFFF; // Saturated
+    CHECK(fields[DOR_TELEMETRY_CURRENT + channelNb] == expected, "Channel %u: %u cA, expected %u", channelNb, fields[DOR_TELEMETRY_CURRENT + channelNb], expected);
+  }
+}
+
+
+int main(void)
+{
+  Protection.currentRMS[0] = CURRENT_FROM_AMPS(2.5);
+  Protection.currentRMS[1] = CURRENT_FROM_AMPS(55.0); // Over the 40.95 A the 12-bit fields saturated at
+  Protection.currentRMS[2] = CURRENT_FROM_AMPS(700.0); // Over the 655.35 A of a 16-bit field
+  Protection.tripElement[1].accumulator = TRIP_ONE / 4;
+
+  static const uint32_t frequencies[] = { 5003, 4761, 5247, 5000 };
+  uint8_t frameNb = 0;
+  for (unsigned i = 0; i < sizeof(frequencies) / sizeof(frequencies[0]); i++)
+  {
+    Metering.frequency = frequencies[i] / 100.0f + 0.001f; // Just above, so the conversion does not round down
+    CheckFrame(++frameNb, 86399 + 65536 * i, 160 * (i + 1) + 0x10000 * i, frequencies[i]);
+  }
+  Metering.frequency = 0;
+  CheckFrame(++frameNb, 0, 4096, 0);
+
+  // The frame number keeps counting past the 4 bits the data packets carry
+  for (unsigned i = 0; i < 20; i++)
+    CheckFrame(++frameNb, i, i * NB_SAMPLES, 0);
+
+  // Frames go out every period, and stop when unsubscribed
+  Stub_NbPackets = 0;
+  Telemetry_Subscribe(3);
+  for (uint32_t cycle = 0; cycle < 9; cycle++)
+    Telemetry_Cycle(cycle * NB_SAMPLES);
+  CHECK(Stub_NbPackets == 3 * NB_FRAME_PACKETS, "%u packets in 9 cycles at a period of 3", Stub_NbPackets);
+  Stub_NbPackets = 0;
+  Telemetry_Subscribe(0);
+  for (uint32_t cycle = 0; cycle < 9; cycle++)
+    Telemetry_Cycle(cycle * NB_SAMPLES);
+  CHECK(Stub_NbPackets == 0, "%u packets after unsubscribing", Stub_NbPackets);
+
+  printf("%u bytes per frame with %u channels\n", NB_FRAME_PACKETS * PACKET_SIZE, NB_PROTECTION_CHANNELS);
+  printf("%s: %d failure(s)\n", Check_Failures ? "FAILED" : "PASSED", Check_Failures);
+  return Check_Failures ? 1 : 0;
+}